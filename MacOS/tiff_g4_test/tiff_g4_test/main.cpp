@@ -12,10 +12,21 @@
 #include "../../../src/TIFF_G4.cpp"
 #include "../../../test_images/weather_icons.h"
 #include "../../../test_images/bart_raw.h"
+#include "../../../test_images/wide_drawing.h"
+#include "../../../test_images/bart_strips.h"
+#include "../../../test_images/bart_tiles.h"
+#include "../../../test_images/bart_2pages.h"
+#include "../../../test_images/bart_bigtiff.h"
+#include "../../../test_images/bart_g3.h"
+#include "../../../test_images/bart_mh.h"
+#include "../../../test_images/bart_ccitt.h"
+#include "../../../test_images/bart_p1.h"
+#include "../../../test_images/bart_fax.h"
 TIFFG4 g4;
 int iLineCount, iOldY;
 int iWidth, iHeight;
 int iDrawWidth;
+uint32_t u32Checksum;
 
 //
 // Return the current time in milliseconds
@@ -43,6 +54,9 @@ void TIFFLOG(int line, char *string, const char *result)
 void TIFFDraw(TIFFDRAW *pDraw)
 {
     iDrawWidth = pDraw->iScaledWidth;
+    for (int i=0; i<(pDraw->iScaledWidth+7)/8; i++) { // only meaningful for 1-bpp output
+        u32Checksum = (u32Checksum * 31) + pDraw->pPixels[i];
+    }
   if (pDraw->y == iOldY+1) {
     iOldY++;
     iLineCount++; // check that line is incrementing correctly
@@ -51,6 +65,68 @@ void TIFFDraw(TIFFDRAW *pDraw)
       }
   }
 } /* TIFFDraw() */
+// Same checksum of the inverted pixels (for BlackIs1 / BlackIsZero images)
+void TIFFDrawInverted(TIFFDRAW *pDraw)
+{
+    int iBytes = (pDraw->iScaledWidth+7)/8;
+    for (int i=0; i<iBytes; i++) {
+        uint8_t uc = ~pDraw->pPixels[i];
+        if (i == iBytes-1 && (pDraw->iScaledWidth & 7))
+            uc |= (0xff >> (pDraw->iScaledWidth & 7)); // the unused bits stay white
+        u32Checksum = (u32Checksum * 31) + uc;
+    }
+    iLineCount++;
+} /* TIFFDrawInverted() */
+// Same checksum as TIFFDraw with every line drawn twice
+void TIFFDrawTwice(TIFFDRAW *pDraw)
+{
+    for (int j=0; j<2; j++) {
+        for (int i=0; i<(pDraw->iScaledWidth+7)/8; i++) {
+            u32Checksum = (u32Checksum * 31) + pDraw->pPixels[i];
+        }
+    }
+    iLineCount += 2;
+} /* TIFFDrawTwice() */
+
+//
+// File callbacks which read from memory and count the bytes read
+//
+const uint8_t *pMemFile;
+int iMemFileSize, iBytesRead;
+void * TIFFMemOpen(const char *szFilename, TIFF_OFFSET *pFileSize)
+{
+    (void)szFilename;
+    *pFileSize = iMemFileSize;
+    iBytesRead = 0;
+    return (void *)pMemFile;
+} /* TIFFMemOpen() */
+void TIFFMemClose(void *pHandle)
+{
+    (void)pHandle;
+} /* TIFFMemClose() */
+int32_t TIFFMemRead(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen)
+{
+    if (iLen > pFile->iSize - pFile->iPos)
+        iLen = (int32_t)(pFile->iSize - pFile->iPos);
+    if (iLen <= 0)
+        return 0;
+    memcpy(pBuf, (const uint8_t *)pFile->fHandle + pFile->iPos, iLen);
+    pFile->iPos += iLen;
+    iBytesRead += iLen;
+    return iLen;
+} /* TIFFMemRead() */
+TIFF_OFFSET TIFFMemSeek(TIFFFILE *pFile, TIFF_OFFSET iPosition)
+{
+    pFile->iPos = iPosition;
+    return iPosition;
+} /* TIFFMemSeek() */
+
+int iPageLines[2];
+// Draw callback for the batch decode (called from several threads)
+void TIFFDrawPages(TIFFDRAW *pDraw)
+{
+    __sync_fetch_and_add(&iPageLines[pDraw->iPage & 1], 1);
+} /* TIFFDrawPages() */
 
 int main(int argc, const char * argv[]) {
     int i, rc, iTime1, iTime2;
@@ -189,6 +265,696 @@ int main(int argc, const char * argv[]) {
     } else {
         TIFFLOG(__LINE__, szTestName, " - FAILED");
     }
+#ifdef TIFF_ARENA
+    // Test 6
+    // Test that an image wider than the old fixed limit (2600 pixels) decodes correctly
+    iOldY = -1;
+    iLineCount = 0;
+    szTestName = (char *)"TIFF wide image (12000 pixels) decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openTIFF((uint8_t *)wide_drawing, (int)sizeof(wide_drawing), TIFFDraw)) {
+        rc = g4.decode();
+        iWidth = g4.getWidth();
+        iHeight = g4.getHeight();
+        g4.close();
+        if (rc == TIFF_SUCCESS && iWidth == 12000 && iHeight == iLineCount && iDrawWidth == iWidth) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("iHeight = %d, lines = %d\n", iHeight, iLineCount);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 7
+    // Test that a caller-supplied buffer is used and that a buffer which is too small is rejected
+    iOldY = -1;
+    iLineCount = 0;
+    szTestName = (char *)"Caller-supplied buffer decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw)) {
+        uint8_t *pBuffer;
+        int iSize, rc2;
+        iHeight = g4.getHeight();
+        iSize = g4.getBufferSize();
+        pBuffer = (uint8_t *)malloc(iSize);
+        g4.setBuffer(pBuffer, iSize);
+        rc = g4.decode();
+        g4.setBuffer(pBuffer, iSize-1);
+        rc2 = g4.decode();
+        g4.close();
+        free(pBuffer);
+        if (rc == TIFF_SUCCESS && iHeight == iLineCount && rc2 == TIFF_OUT_OF_MEMORY) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, rc2 = %d, lines = %d\n", rc, rc2, iLineCount);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+#endif // TIFF_ARENA
+    // Test 8
+    // Test that the specialized (template) decoder draws the same lines and rejects draw parameters which don't match
+    iOldY = -1;
+    iLineCount = 0;
+    szTestName = (char *)"Specialized 2-bpp 1/2 scale decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw)) {
+        int rc2;
+        iWidth = g4.getWidth();
+        iHeight = g4.getHeight();
+        g4.setDrawParameters(0.5f, TIFF_PIXEL_2BPP, 0, 0, iWidth, iHeight, NULL);
+        rc = g4.decode<TIFF_PIXEL_2BPP, 1>();
+        rc2 = g4.decode<TIFF_PIXEL_4BPP, 1>();
+        g4.close();
+        if (rc == TIFF_SUCCESS && iHeight/2 == iLineCount && iDrawWidth == iWidth/2 && rc2 == TIFF_INVALID_PARAMETER) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, rc2 = %d, lines = %d, width = %d\n", rc, rc2, iLineCount, iDrawWidth);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 9
+    // Test that an image split into multiple strips decodes the same as the single strip version
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF multi-strip decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        int rc2 = TIFF_SUCCESS;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        if (g4.openTIFF((uint8_t *)bart_strips, (int)sizeof(bart_strips), TIFFDraw)) {
+            rc = g4.decode();
+            g4.close();
+            if (iLineCount != 122 || u32Checksum != u32Expected)
+                rc = TIFF_DECODE_ERROR;
+#ifdef TIFF_THREADS
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            g4.openTIFF((uint8_t *)bart_strips, (int)sizeof(bart_strips), TIFFDraw);
+            g4.setThreads(4);
+            rc2 = g4.decode();
+            g4.close();
+            if (iLineCount != 122 || u32Checksum != u32Expected)
+                rc2 = TIFF_DECODE_ERROR;
+#endif
+            if (rc == TIFF_SUCCESS && rc2 == TIFF_SUCCESS) {
+              TIFFLOG(__LINE__, szTestName, " - PASSED");
+            } else {
+              TIFFLOG(__LINE__, szTestName, " - FAILED");
+              printf("rc = %d, rc2 = %d, lines = %d\n", rc, rc2, iLineCount);
+            }
+        } else { // open file failed
+          TIFFLOG(__LINE__, szTestName, " - open failed");
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+#ifdef TIFF_TILES
+    // Test 10
+    // Test that a tiled image decodes the same as the single strip version and that a window only draws its lines
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF tiled decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        int iWindowLines = 0;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        if (g4.openTIFF((uint8_t *)bart_tiles, (int)sizeof(bart_tiles), TIFFDraw)) {
+            rc = g4.decode();
+            if (iLineCount != 122 || u32Checksum != u32Expected)
+                rc = TIFF_DECODE_ERROR;
+            iOldY = -1;
+            iLineCount = 0;
+            g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 70, 40, 100, 50, NULL); // spans 3x3 tiles
+            if (g4.decode() == TIFF_SUCCESS)
+                iWindowLines = iLineCount;
+            g4.close();
+            if (rc == TIFF_SUCCESS && iWindowLines == 50 && iDrawWidth == 100) {
+              TIFFLOG(__LINE__, szTestName, " - PASSED");
+            } else {
+              TIFFLOG(__LINE__, szTestName, " - FAILED");
+              printf("rc = %d, window lines = %d\n", rc, iWindowLines);
+            }
+        } else { // open file failed
+          TIFFLOG(__LINE__, szTestName, " - open failed");
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+#endif // TIFF_TILES
+    // Test 11
+    // Test that each page of a multi-page file can be opened and decoded
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF multi-page decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openTIFF((uint8_t *)bart_2pages, (int)sizeof(bart_2pages), TIFFDraw)) {
+        uint32_t u32Expected;
+        int iPages, rc2, rc3 = TIFF_SUCCESS;
+        iPages = g4.getPageCount();
+        g4.decode();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        rc = TIFF_DECODE_ERROR;
+        if (g4.openPage(1))
+            rc = g4.decode();
+        rc2 = g4.openPage(2); // there isn't one
+        g4.close();
+#ifdef TIFF_THREADS
+        iPageLines[0] = iPageLines[1] = 0;
+        g4.openTIFF((uint8_t *)bart_2pages, (int)sizeof(bart_2pages), TIFFDrawPages);
+        rc3 = g4.decodePages(2);
+        g4.close();
+        if (iPageLines[0] != 122 || iPageLines[1] != 122)
+            rc3 = TIFF_DECODE_ERROR;
+        for (i=0; i<2 && rc3 == TIFF_SUCCESS; i++) { // 4-bpp pages at 1/2 and 1/4 scale
+            uint8_t uc4BPP[256];
+            float fScale = (i == 0) ? 0.5f : 0.25f;
+            int iExpected;
+            iPageLines[0] = iPageLines[1] = 0;
+            g4.openTIFF((uint8_t *)bart_2pages, (int)sizeof(bart_2pages), TIFFDrawPages);
+            g4.setDrawParameters(fScale, TIFF_PIXEL_4BPP, 0, 0, 250, 122, uc4BPP);
+            g4.decode(); // the first page on this thread
+            iExpected = iPageLines[0];
+            g4.close();
+            iPageLines[0] = 0;
+            g4.openTIFF((uint8_t *)bart_2pages, (int)sizeof(bart_2pages), TIFFDrawPages);
+            g4.setDrawParameters(fScale, TIFF_PIXEL_4BPP, 0, 0, 250, 122, NULL);
+            rc3 = g4.decodePages(1);
+            g4.close();
+            if (iExpected == 0 || iPageLines[0] != iExpected || iPageLines[1] != iExpected)
+                rc3 = TIFF_DECODE_ERROR;
+        }
+#endif
+        if (iPages == 2 && rc == TIFF_SUCCESS && iLineCount == 122 && u32Checksum == u32Expected && rc2 == 0 && rc3 == TIFF_SUCCESS) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("pages = %d, rc = %d, rc3 = %d, lines = %d\n", iPages, rc, rc3, iLineCount);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 12
+    // Test that a BigTIFF file (8-byte offsets and counts) decodes the same as the classic version
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"BigTIFF decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        if (g4.openTIFF((uint8_t *)bart_bigtiff, (int)sizeof(bart_bigtiff), TIFFDraw)) {
+            rc = g4.decode();
+            g4.close();
+            if (rc == TIFF_SUCCESS && iLineCount == 122 && u32Checksum == u32Expected) {
+              TIFFLOG(__LINE__, szTestName, " - PASSED");
+            } else {
+              TIFFLOG(__LINE__, szTestName, " - FAILED");
+              printf("rc = %d, lines = %d\n", rc, iLineCount);
+            }
+        } else { // open file failed
+          TIFFLOG(__LINE__, szTestName, " - open failed");
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 13
+    // Test that G3 (T.4 2D) and Modified Huffman files decode the same as G4 and
+    // that a damaged G3 line doesn't stop the decoder
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF G3/MH decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        int rc2 = TIFF_DECODE_ERROR, rc3 = TIFF_DECODE_ERROR, iDamagedLines = 0;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        rc = TIFF_DECODE_ERROR;
+        if (g4.openTIFF((uint8_t *)bart_g3, (int)sizeof(bart_g3), TIFFDraw)) {
+            rc = g4.decode();
+            g4.close();
+            if (iLineCount != 122 || u32Checksum != u32Expected)
+                rc = TIFF_DECODE_ERROR;
+        }
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        if (g4.openTIFF((uint8_t *)bart_mh, (int)sizeof(bart_mh), TIFFDraw)) {
+            rc2 = g4.decode();
+            g4.close();
+            if (iLineCount != 122 || u32Checksum != u32Expected)
+                rc2 = TIFF_DECODE_ERROR;
+        }
+        pFuzzData = (uint8_t *)malloc(sizeof(bart_g3));
+        memcpy(pFuzzData, bart_g3, sizeof(bart_g3));
+        pFuzzData[300] ^= 0xff; // somewhere in the middle of the image
+        iOldY = -1;
+        iLineCount = 0;
+        if (g4.openTIFF(pFuzzData, (int)sizeof(bart_g3), TIFFDraw)) {
+            rc3 = g4.decode();
+            g4.close();
+            iDamagedLines = iLineCount;
+        }
+        free(pFuzzData);
+        if (rc == TIFF_SUCCESS && rc2 == TIFF_SUCCESS && rc3 == TIFF_SUCCESS && iDamagedLines == 122) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("G3 rc = %d, MH rc = %d, damaged rc = %d, lines = %d\n", rc, rc2, rc3, iDamagedLines);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 14
+    // Test the CCITTFaxDecode streams of a PDF file: K > 0 with byte aligned
+    // lines, and a G4 stream which ends with an EOFB before the Rows given
+    // (and BlackIs1, so the inverted pixels must match)
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"PDF CCITTFaxDecode streams";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        int rc2 = TIFF_DECODE_ERROR, iLines2 = 0;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        g4.openCCITT(250, 122, 4, TIFF_CCITT_BYTE_ALIGN, 0, (uint8_t *)bart_ccitt_k4, (int)sizeof(bart_ccitt_k4), TIFFDraw);
+        rc = g4.decode();
+        g4.close();
+        if (iLineCount != 122 || u32Checksum != u32Expected)
+            rc = TIFF_DECODE_ERROR;
+        iLineCount = 0;
+        u32Checksum = 0;
+        g4.openCCITT(250, 200, -1, TIFF_CCITT_BYTE_ALIGN | TIFF_CCITT_END_OF_BLOCK | TIFF_CCITT_BLACK_IS_1, 0, (uint8_t *)bart_ccitt_g4, (int)sizeof(bart_ccitt_g4), TIFFDrawInverted);
+        rc2 = g4.decode();
+        g4.close();
+        iLines2 = iLineCount;
+        if (u32Checksum != u32Expected)
+            rc2 = TIFF_DECODE_ERROR;
+        if (rc == TIFF_SUCCESS && rc2 == TIFF_SUCCESS && iLines2 == 122) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("K=4 rc = %d, G4 rc = %d, G4 lines = %d\n", rc, rc2, iLines2);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 15
+    // Test that a window of a multi-strip image draws the same lines as the
+    // single strip version and only reads the strip it's in
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF multi-strip window decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        int iFullRead, iWindowRead = 0, iWindowLines = 0;
+        g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 0, 48, 250, 16, NULL); // the 4th strip
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        pMemFile = bart_strips;
+        iMemFileSize = (int)sizeof(bart_strips);
+        rc = TIFF_DECODE_ERROR;
+        if (g4.openTIFF("bart_strips", TIFFMemOpen, TIFFMemClose, TIFFMemRead, TIFFMemSeek, TIFFDraw)) {
+            rc = g4.decode();
+            g4.close();
+            iFullRead = iBytesRead;
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            g4.openTIFF("bart_strips", TIFFMemOpen, TIFFMemClose, TIFFMemRead, TIFFMemSeek, TIFFDraw);
+            g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 0, 48, 250, 16, NULL);
+            if (g4.decode() == TIFF_SUCCESS && u32Checksum == u32Expected) {
+                iWindowLines = iLineCount;
+                iWindowRead = iBytesRead;
+            }
+            g4.close();
+            if (rc == TIFF_SUCCESS && iWindowLines == 16 && iWindowRead < iFullRead / 2) {
+              TIFFLOG(__LINE__, szTestName, " - PASSED");
+            } else {
+              TIFFLOG(__LINE__, szTestName, " - FAILED");
+              printf("rc = %d, window lines = %d, bytes read = %d of %d\n", rc, iWindowLines, iWindowRead, iFullRead);
+            }
+        } else { // open file failed
+          TIFFLOG(__LINE__, szTestName, " - open failed");
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 16
+    // Test that a BlackIsZero (PhotometricInterpretation=1) file is drawn
+    // inverted; the file has the same coded data as bart_raw. The 2-bpp
+    // output must match the inverted image with the normal photometric.
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF BlackIsZero decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw)) {
+        uint32_t u32Expected;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iLineCount = 0;
+        u32Checksum = 0;
+        if (g4.openTIFF((uint8_t *)bart_p1, (int)sizeof(bart_p1), TIFFDrawInverted)) {
+            int rc2, iLines;
+            uint32_t u32Gray;
+            rc = g4.decode();
+            g4.close();
+            iLines = iLineCount;
+            if (u32Checksum != u32Expected)
+                rc = TIFF_DECODE_ERROR;
+            u32Checksum = 0;
+            g4.openTIFF((uint8_t *)bart_inv, (int)sizeof(bart_inv), TIFFDraw);
+            g4.setDrawParameters(0.25f, TIFF_PIXEL_2BPP, 0, 0, 250, 122, NULL);
+            g4.decode();
+            g4.close();
+            u32Gray = u32Checksum;
+            u32Checksum = 0;
+            g4.openTIFF((uint8_t *)bart_p1, (int)sizeof(bart_p1), TIFFDraw);
+            g4.setDrawParameters(0.25f, TIFF_PIXEL_2BPP, 0, 0, 250, 122, NULL);
+            rc2 = g4.decode();
+            g4.close();
+            if (u32Checksum != u32Gray)
+                rc2 = TIFF_DECODE_ERROR;
+            if (rc == TIFF_SUCCESS && rc2 == TIFF_SUCCESS && iLines == 122) {
+              TIFFLOG(__LINE__, szTestName, " - PASSED");
+            } else {
+              TIFFLOG(__LINE__, szTestName, " - FAILED");
+              printf("1-bpp rc = %d, 2-bpp rc = %d, lines = %d\n", rc, rc2, iLines);
+            }
+        } else { // open file failed
+          TIFFLOG(__LINE__, szTestName, " - open failed");
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 17
+    // Test separate horizontal and vertical scales: twice the height draws
+    // each line twice, and a Y scale of 0 corrects the aspect ratio of a
+    // standard resolution (204x98 dpi) fax page
+    iOldY = -1;
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF X/Y scaling";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDrawTwice)) {
+        uint32_t u32Expected;
+        int rc2, iLines;
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        g4.openRAW(250, 122, BITDIR_MSB_FIRST, (uint8_t *)bart_raw, sizeof(bart_raw), TIFFDraw);
+        g4.setDrawParameters(1.0f, 2.0f, TIFF_PIXEL_1BPP, 0, 0, 250, 122, NULL);
+        rc = g4.decode();
+        g4.close();
+        iLines = iLineCount;
+        if (u32Checksum != u32Expected)
+            rc = TIFF_DECODE_ERROR;
+        iOldY = -1;
+        iLineCount = 0;
+        rc2 = TIFF_DECODE_ERROR;
+        if (g4.openTIFF((uint8_t *)bart_fax, (int)sizeof(bart_fax), TIFFDraw)) {
+            g4.setDrawParameters(1.0f, 0.0f, TIFF_PIXEL_1BPP, 0, 0, 250, 122, NULL);
+            rc2 = g4.decode();
+            g4.close();
+        }
+        if (rc == TIFF_SUCCESS && rc2 == TIFF_SUCCESS && iLines == 244 && iLineCount == 253) { // 122 * 204 / 98
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, fax rc = %d, lines = %d, fax lines = %d\n", rc, rc2, iLines, iLineCount);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 18
+    // Test that rewind() draws the same icons of a sprite sheet as opening
+    // the file again for each one, and that it clears the last error
+    iLineCount = 0;
+    u32Checksum = 0;
+    szTestName = (char *)"TIFF rewind";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    for (i=0; i<4; i++) {
+        iOldY = -1;
+        if (g4.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw)) {
+            g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 46+(i*128), 50, 128, 118, NULL);
+            g4.decode();
+            g4.close();
+        }
+    }
+    if (iLineCount == 4*118) {
+        uint32_t u32Expected = u32Checksum;
+        int rc2 = TIFF_SUCCESS;
+        iLineCount = 0;
+        u32Checksum = 0;
+        g4.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw);
+        g4.decode<TIFF_PIXEL_2BPP, 1>(); // wrong pixel type, leaves an error
+        for (i=0; i<4; i++) {
+            iOldY = -1;
+            g4.rewind();
+            g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 46+(i*128), 50, 128, 118, NULL);
+            rc = g4.decode();
+            if (rc != TIFF_SUCCESS)
+                rc2 = rc;
+        }
+        g4.close();
+        if (rc2 == TIFF_SUCCESS && iLineCount == 4*118 && u32Checksum == u32Expected) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, lines = %d\n", rc2, iLineCount);
+        }
+    } else { // open file failed
+      TIFFLOG(__LINE__, szTestName, " - open failed");
+    }
+    // Test 19
+    // Test that images decoded where they are in memory draw the same lines as
+    // when they're read through the file callbacks, and that data which ends
+    // at the end of its buffer (or is cut short) is decoded safely
+    szTestName = (char *)"TIFF in-place memory decode";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    {
+        const uint8_t *pFiles[3] = {bart_strips, bart_g3, bart_mh};
+        const int iSizes[3] = {(int)sizeof(bart_strips), (int)sizeof(bart_g3), (int)sizeof(bart_mh)};
+        uint32_t u32Mem, u32File;
+        int iMemLines, iFileLines = 0, iBad = 0;
+
+        for (i=0; i<3; i++) {
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            rc = TIFF_DECODE_ERROR;
+            if (g4.openTIFF((uint8_t *)pFiles[i], iSizes[i], TIFFDraw)) {
+                rc = g4.decode();
+                g4.close();
+            }
+            u32Mem = u32Checksum;
+            iMemLines = iLineCount;
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            pMemFile = pFiles[i];
+            iMemFileSize = iSizes[i];
+            if (g4.openTIFF("bart", TIFFMemOpen, TIFFMemClose, TIFFMemRead, TIFFMemSeek, TIFFDraw)) {
+                if (g4.decode() != TIFF_SUCCESS)
+                    rc = TIFF_DECODE_ERROR;
+                g4.close();
+            }
+            u32File = u32Checksum;
+            iFileLines = iLineCount;
+            if (rc != TIFF_SUCCESS || iMemLines != 122 || iFileLines != 122 || u32Mem != u32File)
+                iBad++;
+        }
+        // the raw stream has nothing after it; a heap copy of the exact size
+        // lets a memory checker catch any read past its end
+        for (i=0; i<=64; i++) {
+            int iLen = (int)sizeof(bart_raw) - 64 + i;
+            pFuzzData = (uint8_t *)malloc(iLen);
+            memcpy(pFuzzData, bart_raw, iLen);
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            rc = TIFF_DECODE_ERROR;
+            if (g4.openRAW(250, 122, BITDIR_MSB_FIRST, pFuzzData, iLen, TIFFDraw)) {
+                rc = g4.decode();
+                g4.close();
+            }
+            free(pFuzzData);
+        }
+        if (rc != TIFF_SUCCESS || iLineCount != 122 || u32Checksum != u32Mem)
+            iBad++;
+        if (iBad == 0) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("mismatches = %d, lines = %d\n", iBad, iLineCount);
+        }
+    }
+    // Test 20
+    // Test that the strips are read once each and not past their
+    // StripByteCounts (the whole file is read about once) and that it
+    // draws the same lines with or without a strip buffer
+    szTestName = (char *)"TIFF strip reads";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    {
+        uint32_t u32Expected;
+        uint8_t *pStripBuf = (uint8_t *)malloc(4096);
+        int iFirstRead = 0, iLines = 0;
+
+        iOldY = -1;
+        iLineCount = 0;
+        u32Checksum = 0;
+        g4.openTIFF((uint8_t *)bart_strips, (int)sizeof(bart_strips), TIFFDraw);
+        g4.decode();
+        g4.close();
+        u32Expected = u32Checksum;
+        pMemFile = bart_strips;
+        iMemFileSize = (int)sizeof(bart_strips);
+        rc = TIFF_DECODE_ERROR;
+        for (i=0; i<2; i++) {
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            if (g4.openTIFF("bart_strips", TIFFMemOpen, TIFFMemClose, TIFFMemRead, TIFFMemSeek, TIFFDraw)) {
+                if (i == 1)
+                    g4.setStripBuffer(pStripBuf, 4096);
+                rc = g4.decode();
+                g4.close();
+            }
+            if (rc != TIFF_SUCCESS || u32Checksum != u32Expected)
+                break;
+            if (i == 0)
+                iFirstRead = iBytesRead;
+            iLines += iLineCount;
+        }
+        free(pStripBuf);
+        if (i == 2 && iLines == 244 && iFirstRead < iMemFileSize * 2) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, lines = %d, bytes read = %d of %d\n", rc, iLines, iFirstRead, iMemFileSize);
+        }
+    }
+    // Test 21
+    // Test that reading the strips ahead of the decoder draws the same
+    // lines, for the whole image and for a window of it
+    szTestName = (char *)"TIFF read-ahead";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    {
+        uint32_t u32Expected[2];
+        int iLines[2];
+
+        pMemFile = bart_strips;
+        iMemFileSize = (int)sizeof(bart_strips);
+        rc = TIFF_DECODE_ERROR;
+        for (i=0; i<4; i++) {
+            iOldY = -1;
+            iLineCount = 0;
+            u32Checksum = 0;
+            if (g4.openTIFF("bart_strips", TIFFMemOpen, TIFFMemClose, TIFFMemRead, TIFFMemSeek, TIFFDraw)) {
+#ifdef TIFF_THREADS
+                if (i & 1)
+                    g4.setReadAhead(2);
+#endif
+                if (i & 2)
+                    g4.setDrawParameters(1.0f, TIFF_PIXEL_1BPP, 0, 40, g4.getWidth(), 50, NULL);
+                rc = g4.decode();
+                g4.close();
+            }
+            if (rc != TIFF_SUCCESS)
+                break;
+            if (!(i & 1)) {
+                u32Expected[i>>1] = u32Checksum;
+                iLines[i>>1] = iLineCount;
+            } else if (u32Checksum != u32Expected[i>>1] || iLineCount != iLines[i>>1]) {
+                break;
+            }
+        }
+        if (i == 4 && iLines[0] == 122 && iLines[1] == 50) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, pass = %d, lines = %d\n", rc, i, iLineCount);
+        }
+    }
+#ifdef TIFF_ARENA
+    // Test 22
+    // Test that a wide image scaled past 64K pixels decodes and that
+    // a scaled width which can't be drawn is rejected
+    szTestName = (char *)"TIFF wide image scaled up 6x";
+    TIFFLOG(__LINE__, szTestName, szStart);
+    {
+        int rc2;
+
+        iOldY = -1;
+        iLineCount = 0;
+        rc = TIFF_DECODE_ERROR;
+        rc2 = TIFF_SUCCESS;
+        if (g4.openTIFF((uint8_t *)wide_drawing, (int)sizeof(wide_drawing), TIFFDraw)) {
+            iWidth = g4.getWidth();
+            iHeight = g4.getHeight();
+            g4.setDrawParameters(6.0f, TIFF_PIXEL_1BPP, 0, 0, iWidth, iHeight, NULL);
+            rc = g4.decode();
+            g4.setDrawParameters(2000.0f, TIFF_PIXEL_1BPP, 0, 0, iWidth, iHeight, NULL);
+            rc2 = g4.decode();
+            g4.close();
+        }
+        if (rc == TIFF_SUCCESS && iDrawWidth == iWidth * 6 && iLineCount == iHeight * 6 && rc2 == TIFF_TOO_WIDE) {
+          TIFFLOG(__LINE__, szTestName, " - PASSED");
+        } else {
+          TIFFLOG(__LINE__, szTestName, " - FAILED");
+          printf("rc = %d, rc2 = %d, width = %d, lines = %d\n", rc, rc2, iDrawWidth, iLineCount);
+        }
+    }
+#endif
     // FUZZ testing
     // Randomize the input data (file header and compressed data) and confirm that the library returns an error code
     // and doesn't have an invalid pointer exception
@@ -43,29 +43,26 @@ void setup() {
   spilcdFill(&lcd, 0, DRAW_TO_LCD);
 // A few primary colors for the demo
 const uint16_t usColors[] = {0xffff, 0x7e0, 0xffe0, 0xf800, 0x7ff, 0xf81f, 0x1f, 0x00};
+// The weather icons are all in one image; open it once and rewind() it to
+// draw the next icon instead of opening and parsing it again
+   if (tiff.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw))
+   {
 // Draw 2 full sized (1.0f) weather icons
-   for (i=0; i<2; i++) {
-     if (tiff.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw))
-     {
+     for (i=0; i<2; i++) {
+      tiff.rewind();
       tiff.drawIcon(1.0f, 46+(i*128), 50, 128, 118, i*128, 0, usColors[i]/*FG_COLOR*/, 0/*BG_COLOR*/);
-      tiff.close();
      }
-   }
 // Draw 5 icons at 50% (0.5f) scale
-   for (i=0; i<5; i++) {
-     if (tiff.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw))
-     {
+     for (i=0; i<5; i++) {
+      tiff.rewind();
       tiff.drawIcon(0.5f, 46+(i*128), 50, 128, 118, i*64, 120, usColors[i]/*FG_COLOR*/, 0/*BG_COLOR*/);
-      tiff.close();
      }
-   }
 // Draw 6 icons at 30% (0.3f) scale
-   for (int i=0; i<6; i++) {
-     if (tiff.openTIFF((uint8_t *)weather_icons, (int)sizeof(weather_icons), TIFFDraw))
-     {
+     for (int i=0; i<6; i++) {
+      tiff.rewind();
       tiff.drawIcon(0.3f, 46+(i*128), 50+118, 128, 118, 32+i*46, 190, usColors[i]/*FG_COLOR*/, 0/*BG_COLOR*/);
-      tiff.close();
      }
+     tiff.close();
    }
    delay(5000);
    spilcdFill(&lcd, 0, DRAW_TO_LCD);
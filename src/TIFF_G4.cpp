@@ -35,6 +35,9 @@ static int Decode(TIFFIMAGE *pImage);
 //
 int TIFFG4::openTIFF(uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw)
 {
+#ifdef TIFF_ARENA
+    TIFFFreeBuffers(&_tiff); // opened again without close()
+#endif
     memset(&_tiff, 0, sizeof(TIFFIMAGE));
     _tiff.pfnRead = readMem;
     _tiff.pfnSeek = seekMem;
@@ -51,6 +54,9 @@ int TIFFG4::openTIFF(uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw)
 //
 int TIFFG4::openRAW(int iWidth, int iHeight, int iFillOrder, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw)
 {
+#ifdef TIFF_ARENA
+    TIFFFreeBuffers(&_tiff); // opened again without close()
+#endif
     memset(&_tiff, 0, sizeof(TIFFIMAGE));
     _tiff.pfnRead = readMem;
     _tiff.pfnSeek = seekMem;
@@ -63,14 +69,25 @@ int TIFFG4::openRAW(int iWidth, int iHeight, int iFillOrder, uint8_t *pData, int
     _tiff.iHeight = iHeight;
     _tiff.ucFillOrder = (uint8_t)iFillOrder;
     // Default output values
-    _tiff.window.iScale = 65536; // 1.0 scale
+    _tiff.window.iScale = _tiff.window.iScaleY = 65536; // 1.0 scale
     _tiff.window.x = 0;
     _tiff.window.y = 0; // upper left corner of interest (source pixels)
     _tiff.window.iWidth = iWidth; // dest window size
     _tiff.window.iHeight = iHeight;
     _tiff.window.ucPixelType = TIFF_PIXEL_1BPP;
+    _tiff.iRowsPerStrip = iHeight; // a single strip
     return 1;
 } /* openRAW() */
+//
+// Work with the CCITTFaxDecode stream of a PDF file
+// Pass Columns, Rows, K, the TIFF_CCITT_xxx options and DamagedRowsBeforeError
+//
+int TIFFG4::openCCITT(int iWidth, int iHeight, int iK, int iOptions, int iDamagedRows, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw)
+{
+    openRAW(iWidth, iHeight, BITDIR_MSB_FIRST, pData, iDataSize, pfnDraw);
+    TIFFSetCCITT(&_tiff, iK, iOptions, iDamagedRows);
+    return 1;
+} /* openCCITT() */
 
 void TIFFG4::decodeIncBegin(int iWidth, int iHeight, uint8_t ucFillOrder, TIFF_DRAW_CALLBACK *pfnDraw)
 {
@@ -101,12 +118,48 @@ int TIFFG4::getHeight()
 {
     return _tiff.iHeight;
 } /* getHeight() */
+//
+// Multi-page files
+// Pages are numbered from 0; openPage() parses the page and resets the draw
+// parameters like openTIFF() does for the first one
+//
+int TIFFG4::getPageCount()
+{
+    return TIFFPageCount(&_tiff);
+} /* getPageCount() */
+
+int TIFFG4::openPage(int iPage)
+{
+    return TIFFOpenPage(&_tiff, iPage);
+} /* openPage() */
+//
+// Get ready to decode the current page again (e.g. another icon of a
+// sprite sheet) without opening and parsing the file again
+//
+void TIFFG4::rewind()
+{
+    TIFFRewind(&_tiff);
+} /* rewind() */
+//
+// Read the strips into this buffer (call after opening the image)
+// Each strip which fits is read with one call; larger ones are streamed
+// through it. Without one, strips larger than the internal buffer are read
+// into memory allocated by the library (desktop/server builds)
+//
+void TIFFG4::setStripBuffer(uint8_t *pBuffer, int iSize)
+{
+    _tiff.pStripBuf = pBuffer;
+    _tiff.iStripBufSize = iSize;
+} /* setStripBuffer() */
 
 //
 // File (SD/MMC) based initialization
 //
 int TIFFG4::openTIFF(const char *szFilename, TIFF_OPEN_CALLBACK *pfnOpen, TIFF_CLOSE_CALLBACK *pfnClose, TIFF_READ_CALLBACK *pfnRead, TIFF_SEEK_CALLBACK *pfnSeek, TIFF_DRAW_CALLBACK *pfnDraw)
 {
+#ifdef TIFF_ARENA
+    TIFFFreeBuffers(&_tiff); // opened again without close()
+#endif
     memset(&_tiff, 0, sizeof(TIFFIMAGE));
     _tiff.pfnRead = pfnRead;
     _tiff.pfnSeek = pfnSeek;
@@ -124,21 +177,115 @@ void TIFFG4::close()
 {
     if (_tiff.pfnClose)
         (*_tiff.pfnClose)(_tiff.TIFFFile.fHandle);
+#ifdef TIFF_ARENA
+    TIFFFreeBuffers(&_tiff);
+#endif
 } /* close() */
 
+#ifdef TIFF_ARENA
+//
+// Size of the memory needed to decode the current image
+// with the current draw parameters
+//
+int TIFFG4::getBufferSize()
+{
+    return TIFFBufferSize(&_tiff);
+} /* getBufferSize() */
+//
+// Provide the decoder memory (call after opening the image)
+// If not set, it's allocated from the heap and freed by close()
+//
+void TIFFG4::setBuffer(uint8_t *pBuffer, int iSize)
+{
+    _tiff.pArena = pBuffer;
+    _tiff.iArenaSize = iSize;
+} /* setBuffer() */
+#endif // TIFF_ARENA
+#ifdef TIFF_THREADS
+//
+// Decode the strips of multi-strip images on this many worker threads
+// (call after opening the image, 0 = don't use threads)
+//
+void TIFFG4::setThreads(int iThreads)
+{
+    if (iThreads < 0) iThreads = 0;
+    if (iThreads > TIFF_MAX_THREADS) iThreads = TIFF_MAX_THREADS;
+    _tiff.iThreads = iThreads;
+} /* setThreads() */
+//
+// Read the compressed data of a file ahead of the decoder into this many
+// buffers on a background thread (call after opening the image, 0 = don't)
+// Images in memory are decoded where they are and don't need it
+//
+void TIFFG4::setReadAhead(int iBuffers)
+{
+    _tiff.iReadAhead = TIFFReadAheadBuffers(iBuffers);
+} /* setReadAhead() */
+//
+// Decode all of the pages on iThreads threads (including this one) with the
+// pixel type and scale of setDrawParameters(). The draw callback is called
+// from all of them at once; TIFFDRAW.iPage tells which page is being drawn.
+//
+int TIFFG4::decodePages(int iThreads)
+{
+    return TIFFDecodePages(&_tiff, iThreads);
+} /* decodePages() */
+#endif // TIFF_THREADS
+
+//
+// The scale of a specialized decoder (1/2^iScaleShift, 16.16 fixed point)
+// TIFF_SCALE_ANY (-1) uses the window's scale instead, clamp it to a valid shift
+//
+#define TIFF_SHIFT_SCALE(iScaleShift) ((uint32_t)0x10000 >> ((iScaleShift) < 0 ? 0 : (iScaleShift)))
+//
+// The draw function for one pixel type, scale and clipping, with the other
+// cases removed at compile time
+//
+template <int iPixelType, int iScaleShift, int bClipped>
+static int TIFFDrawLineT(TIFFIMAGE *pPage, int y, TIFF_FLIP *pCurFlips)
+{
+    uint32_t u32Scale = (iScaleShift == TIFF_SCALE_ANY) ? pPage->window.iScale : TIFF_SHIFT_SCALE(iScaleShift);
+    uint32_t u32ScaleY = (iScaleShift == TIFF_SCALE_ANY) ? pPage->window.iScaleY : TIFF_SHIFT_SCALE(iScaleShift);
+    return TIFFDrawLineCore(pPage, y, pCurFlips, (uint8_t)iPixelType, u32Scale, u32ScaleY, bClipped);
+} /* TIFFDrawLineT() */
+//
+// Decode an image with a specialized draw loop
+// returns TIFF_SUCCESS or an error code
+//
+template <int iPixelType, int iScaleShift>
+int TIFFG4::decode(int iDestX, int iDestY)
+{
+    if (_tiff.window.ucPixelType != iPixelType || (iScaleShift != TIFF_SCALE_ANY && (_tiff.window.iScale != TIFF_SHIFT_SCALE(iScaleShift) || _tiff.window.iScaleY != _tiff.window.iScale))) {
+        _tiff.iError = TIFF_INVALID_PARAMETER;
+        return TIFF_INVALID_PARAMETER;
+    }
+    _tiff.window.dstx = iDestX;
+    _tiff.window.dsty = iDestY;
+    if (_tiff.window.x == 0 && _tiff.window.y == 0 && _tiff.window.iWidth == _tiff.iWidth && _tiff.window.iHeight == _tiff.iHeight)
+        return DecodeLines(&_tiff, TIFFDrawLineT<iPixelType, iScaleShift, 0>); // whole image
+    return DecodeLines(&_tiff, TIFFDrawLineT<iPixelType, iScaleShift, 1>);
+} /* decode() */
+// The supported combinations
+template int TIFFG4::decode<TIFF_PIXEL_1BPP, 0>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_2BPP, 1>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_2BPP, 2>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_2BPP, 3>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_4BPP, 1>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_4BPP, 2>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_4BPP, 3>(int iDestX, int iDestY);
+template int TIFFG4::decode<TIFF_PIXEL_16BPP, TIFF_SCALE_ANY>(int iDestX, int iDestY);
+
 int TIFFG4::drawIcon(float scale, int iSrcX, int iSrcY, int iSrcWidth, int iSrcHeight, int iDestX, int iDestY, uint16_t usFGColor, uint16_t usBGColor)
 {
-    _tiff.window.iScale = (uint32_t)(scale * 65536.0f); // convert to uint32
+    _tiff.window.iScale = _tiff.window.iScaleY = (uint32_t)(scale * 65536.0f); // convert to uint32
     _tiff.window.x = iSrcX;
     _tiff.window.y = iSrcY; // upper left corner of interest (source pixels)
     _tiff.window.iWidth = iSrcWidth; // width of destination window (for clipping purposes)
     _tiff.window.iHeight = iSrcHeight;
-    _tiff.window.dstx = iDestX;
-    _tiff.window.dsty = iDestY;
     _tiff.window.ucPixelType = TIFF_PIXEL_16BPP;
     _tiff.usFG = usFGColor;
     _tiff.usBG = usBGColor;
-    return Decode(&_tiff);
+    return decode<TIFF_PIXEL_16BPP, TIFF_SCALE_ANY>(iDestX, iDestY);
 } /* drawIcon() */
 
 //
@@ -158,6 +305,16 @@ void TIFFG4::setDrawParameters(float scale, int iPixelType, int iStartX, int iSt
     _tiff.window.iHeight = iHeight;
     _tiff.window.p4BPP = p4BPPBuf; // user-supplied buffer for 4-bpp grayscale output
     _tiff.window.ucPixelType = (uint8_t)iPixelType;
+    _tiff.window.iScaleY = _tiff.window.iScale;
+} /* setDrawParameters() */
+//
+// Separate horizontal and vertical scales
+// A yscale of 0 corrects the aspect ratio with the resolution tags
+//
+void TIFFG4::setDrawParameters(float xscale, float yscale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf)
+{
+    setDrawParameters(xscale, iPixelType, iStartX, iStartY, iWidth, iHeight, p4BPPBuf);
+    TIFFSetScaleY(&_tiff, yscale);
 } /* setDrawParameters() */
 //
 // Decode an image
@@ -15,6 +15,9 @@
 #define __TIFFG4__
 
 #if defined( __MACH__ ) || defined( __LINUX__ )
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t for fseeko()/ftello() on 32-bit systems
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
@@ -49,15 +52,256 @@
 #define MAX_IMAGE_WIDTH 200
 #else
 #define MAX_BUFFERED_PIXELS 1024
+#if defined( __MACH__ ) || defined( __LINUX__ )
+#define TIFF_FILE_BUF_SIZE 16384 // room for wide G3 (1D) lines, they're read a whole line at a time
+#else
 #define TIFF_FILE_BUF_SIZE 2048
+#endif
 //#define TIFF_FILE_BUF_SIZE 300
 #define MAX_IMAGE_WIDTH 2600
 #endif
+//
+// Desktop/server builds decode the mode codes and the horizontal runs through
+// wide (12-bit) lookup tables built in RAM at startup (48K). A single probe
+// resolves a complete makeup+terminating run or a pair of vertical codes.
+// MCU targets keep the original small tables (in FLASH with PROGMEM).
+// Define TIFF_WIDE_TABLES or TIFF_LEGACY_TABLES to override the default.
+//
+#if !defined( TIFF_WIDE_TABLES ) && !defined( TIFF_LEGACY_TABLES )
+#if defined( __MACH__ ) || defined( __LINUX__ )
+#define TIFF_WIDE_TABLES
+#endif
+#endif
+#ifdef NO_RAM
+#undef TIFF_WIDE_TABLES // the NO_RAM decoder only uses the small tables
+#endif
+#ifndef __GNUC__
+#undef TIFF_WIDE_TABLES // they're built by a constructor function (GCC/Clang)
+#endif
+//
+// Desktop/server builds (TIFF_ARENA) have no fixed image width limit. The flips
+// and the output line buffer are carved out of a memory arena sized from the
+// actual image and draw parameters. The caller can supply the arena with
+// setBuffer() after opening the image (see getBufferSize()), otherwise it's
+// allocated from the heap on the first decode and freed by close().
+// Define TIFF_STATIC_BUFFERS to keep the fixed size arrays in TIFFIMAGE.
+//
+#if !defined( TIFF_ARENA ) && !defined( TIFF_STATIC_BUFFERS )
+#if defined( __MACH__ ) || defined( __LINUX__ )
+#define TIFF_ARENA
+#endif
+#endif
+#ifdef NO_RAM
+#undef TIFF_ARENA
+#endif
+//
+// The compressed data of a strip is read with one call when it fits in the
+// buffer, and the reads stop at the end given by StripByteCounts. Strips larger
+// than ucFileBuf go through a strip buffer; the caller can supply it with
+// setStripBuffer() after opening the image, otherwise desktop/server builds
+// allocate one the size of the strip (up to TIFF_MAX_STRIP_BUF bytes) and
+// free it in close(). Larger strips are streamed through it.
+//
+#ifndef TIFF_MAX_STRIP_BUF
+#define TIFF_MAX_STRIP_BUF (1024 * 1024)
+#endif
+//
+// The flips (color change positions) are 16-bit, which allows images up to
+// 32K pixels wide. Define TIFF_32BIT_FLIPS for anything wider.
+//
+#ifdef TIFF_32BIT_FLIPS
+typedef int32_t TIFF_FLIP;
+#define TIFF_FLIP_MAX 0x3fffffff
+#else
+typedef int16_t TIFF_FLIP;
+#define TIFF_FLIP_MAX 0x7fff
+#endif
+// Each flips array holds a line (a color change per pixel at most) + the
+// terminators, slack for a corrupt line and 4 TIFF_FLIP_MAX sentinels at the end
+#define TIFF_FLIPS_PER_LINE(w) (((w) + 18) & ~7)
+//
+// NO_RAM builds can define TIFF_FLIP_CACHE as the number of color changes per
+// line to remember (e.g. 256). The changes of each decoded line are recorded as
+// its black runs are drawn and serve the reference line lookups of the next
+// line, so only lines with more changes than that fall back to scanning the
+// reference bitmap. The cost is 4 bytes of RAM per entry (two lines).
+// The reference line passed to TIFF_decode1Line() must be the line decoded by
+// the previous call.
+//
+#if defined( TIFF_FLIP_CACHE ) && !defined( NO_RAM )
+#undef TIFF_FLIP_CACHE // the flips decoder already has whole lines
+#endif
+#ifdef TIFF_FLIP_CACHE
+typedef struct tiff_flip_cache_tag
+{
+    int16_t sFlips[2][TIFF_FLIP_CACHE]; // start, end of each black run
+    int16_t sCount[2]; // entries used, -1 = nothing cached for that line
+    uint8_t bPartial[2]; // line had more changes than fit
+    uint8_t ucCur; // which of the 2 is the line being decoded
+} TIFFFLIPCACHE;
+#endif
+#ifdef TIFF_ARENA
+#define TIFF_MAX_WIDTH (TIFF_FLIP_MAX - 64) // a0 must stay below the sentinels
+#define TIFF_MAX_SCALED_WIDTH (1 << 24) // keeps the scaled line sizes within an int
+#else
+#define TIFF_MAX_WIDTH MAX_IMAGE_WIDTH
+#endif
+// largest 16.16 scale; the gray and color output doubles it and
+// the line accumulator must not wrap
+#define TIFF_MAX_SCALE 0x3fff8000
+//
+// 64-bit little-endian targets which allow unaligned reads (x86-64, AArch64)
+// keep 64 bits of the compressed stream in the accumulator and refill it with
+// a single load + byte swap; up to 56 bits can be consumed between refills.
+// Everything else assembles a 32-bit word from 4 byte reads.
+// Define TIFF_32BIT_READER to force the portable reader.
+//
+#if !defined( TIFF_32BIT_READER ) && !defined( NO_RAM ) && defined( __GNUC__ ) && (defined( __x86_64__ ) || defined( __aarch64__ )) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define TIFF_64BIT_READER
+#define REGISTER_WIDTH 64
+typedef uint64_t BIGUINT;
+static inline uint64_t TIFFMotoLong64(const uint8_t *p)
+{
+    uint64_t u;
+    memcpy(&u, p, sizeof(u)); // compiles to a single unaligned load
+    return __builtin_bswap64(u);
+}
+#define TIFFMOTOLONG(p) TIFFMotoLong64(p)
+#else
+// Due to unaligned memory causing an exception, we have to do these macros the slow way
+#define TIFFMOTOLONG(p) (((uint32_t)(*p)<<24UL) + ((uint32_t)(*(p+1))<<16UL) + ((uint32_t)(*(p+2))<<8UL) + (uint32_t)(*(p+3)))
+// Must be a 32-bit target processor
+#define REGISTER_WIDTH 32
+typedef uint32_t BIGUINT;
+#endif
+//
+// Targets which read FLASH and RAM with the same pointers (desktop/server and
+// ARM) decode the data of openTIFF(), openRAW() and openCCITT() where it is
+// instead of copying it through ucFileBuf. There is no guard region after the
+// caller's data, so the bit reader's refills go through TIFFLOADBITS(); within
+// a word of the end, TIFFTailLoad() reads the last bytes followed by the guard
+// region the decoder would see in ucFileBuf. Data with the LSB first fill
+// order is still copied (and reversed) through ucFileBuf.
+// Define TIFF_ZERO_COPY or TIFF_COPY_INPUT to override the default.
+//
+#if !defined( TIFF_ZERO_COPY ) && !defined( TIFF_COPY_INPUT ) && !defined( NO_RAM )
+#if defined( __MACH__ ) || defined( __LINUX__ ) || defined( __arm__ )
+#define TIFF_ZERO_COPY
+#endif
+#endif
+#ifdef TIFF_ZERO_COPY
+#define TIFFLOADBITS(pPage, p) (((p) < (pPage)->pLoadEnd) ? TIFFMOTOLONG(p) : TIFFTailLoad(pPage, p))
+#else
+#define TIFFLOADBITS(pPage, p) TIFFMOTOLONG(p)
+#endif
+//
+// On Linux, TIFF_openTIFFFile() maps regular files read-only and decodes them
+// like a file in memory (in place with TIFF_ZERO_COPY) instead of reading
+// them. Small files and files which can't be mapped are read as before.
+// Define TIFF_MMAP or TIFF_NO_MMAP to override the default.
+//
+#if !defined( TIFF_MMAP ) && !defined( TIFF_NO_MMAP ) && !defined( NO_RAM ) && defined( __LINUX__ )
+#define TIFF_MMAP
+#endif
+//
+// The files which aren't mapped are read with pread() at the position kept in
+// their TIFFFILE instead of through a FILE * with its own file position
+// (small files are read whole by one pread() and decoded from memory).
+// Copies of the TIFFFILE (the page and strip worker threads) read the same
+// descriptor at the same time without locks. Define TIFF_PREAD or
+// TIFF_NO_PREAD to override the default.
+//
+#if !defined( TIFF_PREAD ) && !defined( TIFF_NO_PREAD ) && !defined( NO_RAM ) && defined( __LINUX__ )
+#define TIFF_PREAD
+#endif
+//
+// On x86-64 desktop/server builds the per-line pixel kernels (bit order
+// reversal, black run fill, scale-to-gray and RGB565 conversion) have SSE2,
+// SSSE3 and AVX2 versions. The best one for the CPU is selected at startup and
+// the original C code is the fallback. Define TIFF_NO_SIMD to only build the
+// C code or TIFF_SIMD_VERIFY to run both versions of every kernel call and
+// abort if the outputs differ.
+//
+#if !defined( TIFF_NO_SIMD ) && !defined( NO_RAM ) && defined( __GNUC__ ) && defined( __x86_64__ ) && (defined( __MACH__ ) || defined( __LINUX__ ))
+#define TIFF_SIMD
+#endif
+//
+// Desktop/server builds can decode the strips of a multi-strip image on a
+// pool of threads (see setThreads()). Each strip is coded on its own, so the
+// workers turn them into flips while the calling thread draws the lines in
+// order. Define TIFF_NO_THREADS to leave out the pthreads code.
+//
+#if defined( TIFF_ARENA ) && !defined( TIFF_NO_THREADS )
+#define TIFF_THREADS
+#define TIFF_MAX_THREADS 32
+#endif
+//
+// They can also read the compressed data of a file ahead of the decoder on a
+// background thread (see setReadAhead()), into a ring of buffers of up to
+// TIFF_READ_AHEAD_CHUNK bytes. The decoder only waits for a read when the
+// source can't keep up.
+//
+#ifdef TIFF_THREADS
+#define TIFF_MAX_READ_AHEAD 16
+#ifndef TIFF_READ_AHEAD_CHUNK
+#define TIFF_READ_AHEAD_CHUNK 65536
+#endif
+#if TIFF_READ_AHEAD_CHUNK < TIFF_FILE_BUF_SIZE
+#error "TIFF_READ_AHEAD_CHUNK must be at least TIFF_FILE_BUF_SIZE"
+#endif
+#endif
+//
+// Desktop/server builds also decode tiled images (TileWidth/TileLength).
+// Only the tiles which overlap the draw window are read and decoded, a row of
+// tiles at a time, so a small region of a large tiled page is fast to draw.
+// Other builds return TIFF_UNSUPPORTED_FEATURE for tiled images.
+//
+#ifdef TIFF_ARENA
+#define TIFF_TILES
+#endif
+//
+// File positions and offsets are 64-bit on desktop/server builds for files
+// larger than 2GB (BigTIFF). MCU builds keep them 32-bit unless
+// TIFF_64BIT_FILES is defined.
+//
+#if !defined( TIFF_64BIT_FILES ) && (defined( __MACH__ ) || defined( __LINUX__ ))
+#define TIFF_64BIT_FILES
+#endif
+#ifdef TIFF_64BIT_FILES
+typedef int64_t TIFF_OFFSET;
+#define TIFF_OFFSET_MAX 0x7fffffffffffffffLL
+#else
+typedef int32_t TIFF_OFFSET;
+#define TIFF_OFFSET_MAX 0x7fffffff
+#endif
 #define FILE_HIGHWATER ((TIFF_FILE_BUF_SIZE * 3) >> 2)
+// The compressed data in ucFileBuf is always followed by a guard region which
+// stops the decoder with an error in any state, so the VLC loops don't need to
+// check for the end of the data (it includes room for the last 64-bit read)
+#define TIFF_GUARD_SIZE 32
 #define TIFF_TAG_SIZE 12
+#define TIFF_BIGTAG_SIZE 20 // BigTIFF
 #define MAX_TIFF_TAGS 128
+#define TIFF_MAX_PAGES 65535 // stops a corrupt (circular) IFD chain
 #define BITDIR_MSB_FIRST     1
 #define BITDIR_LSB_FIRST     2
+// Compression tag values which can be decoded
+#define TIFF_COMPRESSION_CCITT_RLE 2 // Modified Huffman, 1D lines which start on a byte
+#define TIFF_COMPRESSION_CCITT_T4  3 // Group 3, 1D or 2D lines which start with an EOL
+#define TIFF_COMPRESSION_CCITT_T6  4 // Group 4
+// T4Options tag bits
+#define TIFF_T4_2D           1 // a tag bit after each EOL tells if the line is 1D or 2D
+#define TIFF_T4_UNCOMPRESSED 2
+#define TIFF_T4_FILLBITS     4 // EOLs end on a byte boundary
+// PhotometricInterpretation tag values
+#define TIFF_PHOTOMETRIC_WHITEISZERO 0
+#define TIFF_PHOTOMETRIC_BLACKISZERO 1 // the output is inverted
+// openCCITT() options, the CCITTFaxDecode parameters of a PDF stream
+#define TIFF_CCITT_BYTE_ALIGN   1 // EncodedByteAlign
+#define TIFF_CCITT_END_OF_LINE  2 // EndOfLine, every line starts with an EOL
+#define TIFF_CCITT_END_OF_BLOCK 4 // EndOfBlock (the PDF default), the data can end early with an EOFB or RTC
+#define TIFF_CCITT_BLACK_IS_1   8 // BlackIs1
+#define TIFF_END_OF_BLOCK -1 // (private) returned by the line decoder when the data ended early
 
 // Error codes returned by getLastError()
 enum {
@@ -67,7 +311,8 @@ enum {
     TIFF_UNSUPPORTED_FEATURE,
     TIFF_INVALID_FILE,
     TIFF_NEED_MORE_DATA,
-    TIFF_TOO_WIDE
+    TIFF_TOO_WIDE,
+    TIFF_OUT_OF_MEMORY
 };
 //
 // Output pixel types
@@ -80,13 +325,27 @@ enum {
     TIFF_PIXEL_4BPP,
     TIFF_PIXEL_16BPP
 };
+#define TIFF_SCALE_ANY -1 // for the C++ specialized decoders
+
+//
+// The StripOffsets/TileOffsets or StripByteCounts/TileByteCounts tag; the
+// array is read from the file one entry at a time unless it fits in the tag
+//
+typedef struct tiff_tag_array_tag
+{
+    uint8_t ucValue[8]; // the values or the file offset of the array
+    uint8_t ucType; // 3 = SHORT, 4 = LONG, 16 = LONG8 (BigTIFF), 0 = missing
+} TIFFTAGARRAY;
 
 typedef struct tiff_file_tag
 {
-  int32_t iPos; // current file position
-  int32_t iSize; // file size
+  TIFF_OFFSET iPos; // current file position
+  TIFF_OFFSET iSize; // file size
   uint8_t *pData; // memory file pointer
   void * fHandle; // class pointer to File/SdFat or whatever you want
+#ifdef TIFF_THREADS
+  void * pPool; // decodePages() threads sharing the file (the lock for reading it)
+#endif
 } TIFFFILE;
 
 //
@@ -97,7 +356,8 @@ typedef struct tiff_window_tag
     int x, y; // upper left corner of interest (source pixels)
     int dstx, dsty; // destination on output
     float fScale;
-    uint32_t iScale; // 16:16 fixed scale factor (e.g. 0.5 = 0x8000)
+    uint32_t iScale; // 16:16 fixed scale factor (e.g. 0.5 = 0x8000), horizontal
+    uint32_t iScaleY; // 16:16 fixed vertical scale factor
     int iWidth, iHeight; // destination window size (for clipping purposes)
     uint8_t *p4BPP; // user-supplied buffer for 4-bpp grayscale output
     uint8_t ucPixelType;
@@ -109,18 +369,32 @@ typedef struct tiff_draw_tag
     int iScaledWidth, iScaledHeight; // width & height of the scaled region
     int iWidth, iHeight; // size of entire image in pixels
     int iDestX, iDestY; // destination coordinates on output
+    int iPage; // page being drawn (starting at 0)
     void *pUser; // user pointer
-    uint8_t *pPixels; // 1, 2 or 16-bit pixels (for drawIcon)
+    uint8_t *pPixels; // 1, 2 or 16-bit pixels (for drawIcon); read-only, it can be sent again for the next line
     uint8_t ucPixelType, ucLast;
 } TIFFDRAW;
 
 // Callback function prototypes
 typedef int32_t (TIFF_READ_CALLBACK)(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen) REENTRANT;
-typedef int32_t (TIFF_SEEK_CALLBACK)(TIFFFILE *pFile, int32_t iPosition) REENTRANT;
+typedef TIFF_OFFSET (TIFF_SEEK_CALLBACK)(TIFFFILE *pFile, TIFF_OFFSET iPosition) REENTRANT;
 typedef void (TIFF_DRAW_CALLBACK)(TIFFDRAW *pDraw) REENTRANT;
-typedef void * (TIFF_OPEN_CALLBACK)(const char *szFilename, int32_t *pFileSize) REENTRANT;
+typedef void * (TIFF_OPEN_CALLBACK)(const char *szFilename, TIFF_OFFSET *pFileSize) REENTRANT;
 typedef void (TIFF_CLOSE_CALLBACK)(void *pHandle) REENTRANT;
 
+//
+// What Decode_one_line() found in the line it decoded (ucLineType)
+//
+#define TIFF_LINE_NEW 0
+#define TIFF_LINE_WHITE 1 // no black pixels
+#define TIFF_LINE_SAME 2 // same flips as the reference (previous) line
+//
+// What the output line buffer holds (ucRowState flags)
+//
+#define TIFF_ROW_WHITE 1 // nothing drawn since it was cleared
+#define TIFF_ROW_LAST 2 // only the last decoded line (1-bpp)
+#define TIFF_ROW_SENT 4 // already passed to the draw callback, not cleared yet
+
 //
 // our private structure to hold a TIFF image decode state
 //
@@ -130,14 +404,19 @@ typedef struct tiff_image_tag
     int iError;
     int y; // last y value drawn
     int iVLCOff, iVLCSize;
-    int iStripSize, iStripOffset;
+    int iStripSize;
+    TIFF_OFFSET iStripOffset;
     int iPitch; // width in bytes of output buffer
     uint32_t u32Accum; // fractional scaling accumulator
-    uint32_t ulBitOff, ulBits; // vlc decode variables
+    uint32_t ulBitOff; // vlc decode variables
+    BIGUINT ulBits;
     uint8_t *pBuf; // current buffer pointer
     uint8_t ucCompression, ucPhotometric, ucFillOrder, ucAligned;
 #ifdef NO_RAM
     uint8_t *pSrc;
+#ifdef TIFF_FLIP_CACHE
+    TIFFFLIPCACHE cache;
+#endif
 #else
     TIFF_READ_CALLBACK *pfnRead;
     TIFF_SEEK_CALLBACK *pfnSeek;
@@ -146,13 +425,50 @@ typedef struct tiff_image_tag
     TIFF_CLOSE_CALLBACK *pfnClose;
     TIFFFILE TIFFFile;
     TIFFWINDOW window;
+    int iStripCount, iRowsPerStrip; // for tiled images, the number of tiles and the tile height
+    int iTileWidth, iTileHeight; // 0 if the image is stored in strips
+    TIFFTAGARRAY StripOffsets, StripSizes; // or the tile offsets and sizes
+    uint8_t ucMotorola; // byte order of the file
+    uint8_t ucT4Options; // TIFF_T4_xxx bits for Compression = 3
+    uint8_t ucBigTIFF; // 64-bit offsets and counts
+    uint8_t ucCCITT; // TIFF_CCITT_xxx options of a raw stream (see openCCITT())
+    uint32_t u32XRes, u32YRes; // XResolution and YResolution in 16:16 fixed, 0 if not given
+    int iDamagedRows, iMaxDamagedRows; // G3 lines replaced so far in this strip and how many can be (-1 = no limit)
+    TIFF_OFFSET iFirstIFD; // the IFD of the first page
+    int iPage, iPageCount; // current page, number of pages (0 = not counted yet)
+#ifdef TIFF_THREADS
+    int iThreads; // worker threads for multi-strip images, 0 = decode on the calling thread
+    int iReadAhead; // buffers read ahead on a background thread, 0 = read when they're needed
+#endif
     void *pUser;
     uint16_t usFG, usBG; // RGB565 colors for drawIcon()
-    int16_t *pCur, *pRef; // current state of current vs reference flips
-    int16_t CurFlips[MAX_IMAGE_WIDTH];
-    int16_t RefFlips[MAX_IMAGE_WIDTH];
+    TIFF_FLIP *pCur, *pRef; // current state of current vs reference flips
+    uint8_t *pDataEnd; // where the guard region starts (the G3 EOL search stops there)
+    uint8_t *pLoadEnd; // refills from here on use TIFFTailLoad() (see TIFFSetDataEnd())
+    uint8_t *pVLC; // the compressed data buffer (ucFileBuf or the strip buffer)
+    int iVLCBufSize; // its size, not counting the guard region
+    TIFF_OFFSET iReadEnd; // file position where the reads of the current strip stop
+    uint8_t *pStripBuf; // caller-supplied strip buffer (see setStripBuffer())
+    int iStripBufSize;
+    int iFlipCount; // flips (incl. terminators) in the last decoded line, 0 if unknown
+    uint8_t ucLineType, ucRowState; // lets TIFFDrawLine() reuse the last output for blank and repeated lines
+#ifdef TIFF_ARENA
+    TIFF_FLIP *CurFlips, *RefFlips; // these 3 point into the arena
+    uint8_t *ucPixels;
+    int iPixelSize; // size of the ucPixels buffer
+    uint8_t *pArena; // caller-supplied arena
+    int iArenaSize;
+    uint8_t *pHeap; // arena allocated by the library (when none was supplied)
+    int iHeapSize;
+    uint8_t *pStripHeap; // strip buffer allocated by the library (when none was supplied)
+    int iStripHeapSize;
+    TIFF_OFFSET *pPageIFD; // the IFD of each page (see getPageCount())
+#else
+    TIFF_FLIP CurFlips[TIFF_FLIPS_PER_LINE(MAX_IMAGE_WIDTH)];
+    TIFF_FLIP RefFlips[TIFF_FLIPS_PER_LINE(MAX_IMAGE_WIDTH)];
     uint8_t ucPixels[MAX_BUFFERED_PIXELS];
-    uint8_t ucFileBuf[TIFF_FILE_BUF_SIZE]; // holds temp data and pixel stack
+#endif // TIFF_ARENA
+    uint8_t ucFileBuf[TIFF_FILE_BUF_SIZE + TIFF_GUARD_SIZE]; // holds temp data and pixel stack
 #endif // NO_RAM
 } TIFFIMAGE;
 
@@ -163,20 +479,56 @@ typedef struct tiff_image_tag
 class TIFFG4
 {
   public:
+#ifdef TIFF_ARENA
+    TIFFG4() { memset(&_tiff, 0, sizeof(_tiff)); }
+    ~TIFFG4() { free(_tiff.pHeap); free(_tiff.pStripHeap); free(_tiff.pPageIFD); }
+    TIFFG4(const TIFFG4 &) = delete; // it owns its buffers
+    TIFFG4 &operator=(const TIFFG4 &) = delete;
+#endif
     int openTIFF(uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw);
     int openTIFF(const char *szFilename, TIFF_OPEN_CALLBACK *pfnOpen, TIFF_CLOSE_CALLBACK *pfnClose, TIFF_READ_CALLBACK *pfnRead, TIFF_SEEK_CALLBACK *pfnSeek, TIFF_DRAW_CALLBACK *pfnDraw);
     int openRAW(int iWidth, int iHeight, int iFillOrder, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw);
+    // A CCITTFaxDecode stream of a PDF file; K, the TIFF_CCITT_xxx options and
+    // DamagedRowsBeforeError come from its DecodeParms (Rows is required)
+    int openCCITT(int iWidth, int iHeight, int iK, int iOptions, int iDamagedRows, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw);
     void close();
     void setDrawParameters(float scale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf);
+    // Separate horizontal and vertical scales; a yscale of 0 corrects the aspect
+    // ratio with the XResolution/YResolution tags (e.g. 204x98 dpi fax pages)
+    void setDrawParameters(float xscale, float yscale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf);
     int drawIcon(float scale, int iSrcX, int iSrcY, int iSrcWidth, int iSrcHeight, int iDstX, int iDstY, uint16_t usFGColor, uint16_t usBGColor);
     void setUserPointer(void *p);
     int decode(int iDstX=0, int iDstY=0);
+    // Decode with the draw loop specialized at compile time for one pixel type
+    // and scale (1/2^iScaleShift or TIFF_SCALE_ANY). Available for 1-bpp at 1:1,
+    // 2/4-bpp at 1/2 to 1/8 and RGB565 at any scale. setDrawParameters() must
+    // match (with the same X and Y scale unless it's TIFF_SCALE_ANY) or
+    // TIFF_INVALID_PARAMETER is returned
+    template <int iPixelType, int iScaleShift> int decode(int iDstX=0, int iDstY=0);
     int decodeInc(int bHasMoreData);
     void decodeIncBegin(int iWidth, int iHeight, uint8_t ucFillOrder, TIFF_DRAW_CALLBACK *pfnDraw);
     int addData(uint8_t *pData, int iLen);
     int getWidth();
     int getHeight();
     int getLastError();
+    int getPageCount();
+    int openPage(int iPage);
+    // Decode the current page again (with new draw parameters) without
+    // opening it again; the parsed header and the callbacks are kept
+    void rewind();
+    // Read the strips into this buffer (call after opening the image)
+    void setStripBuffer(uint8_t *pBuffer, int iSize);
+#ifdef TIFF_ARENA
+    int getBufferSize();
+    void setBuffer(uint8_t *pBuffer, int iSize);
+#endif
+#ifdef TIFF_THREADS
+    void setThreads(int iThreads);
+    // Read the compressed data of a file ahead of the decoder into this many
+    // buffers on a background thread (call after opening, 0 = don't)
+    void setReadAhead(int iBuffers);
+    int decodePages(int iThreads);
+#endif
 
   private:
     TIFFIMAGE _tiff;
@@ -189,31 +541,43 @@ class TIFFG4
 int TIFF_openTIFFFile(TIFFIMAGE *pImage, const char *szFilename, TIFF_OPEN_CALLBACK *pfnOpen, TIFF_CLOSE_CALLBACK *pfnClose, TIFF_READ_CALLBACK *pfnRead, TIFF_SEEK_CALLBACK *pfnSeek, TIFF_DRAW_CALLBACK *pfnDraw);
 #endif
     int TIFF_openRAW(TIFFIMAGE *pImage, int iWidth, int iHeight, int iFillOrder, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw);
+    int TIFF_openCCITT(TIFFIMAGE *pImage, int iWidth, int iHeight, int iK, int iOptions, int iDamagedRows, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw);
     void TIFF_close(TIFFIMAGE *pImage);
     void TIFF_setDrawParameters(TIFFIMAGE *pImage, float scale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf);
+    void TIFF_setDrawParametersXY(TIFFIMAGE *pImage, float xscale, float yscale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf);
     int TIFF_decode(TIFFIMAGE *pImage);
     void TIFF_decodeIncBegin(TIFFIMAGE *pPage, int iWidth, int iHeight, uint8_t ucFillOrder, TIFF_DRAW_CALLBACK *pfnDraw);
     int TIFF_decodeInc(TIFFIMAGE *pImage, int bHasMoreData);
     int TIFF_getWidth(TIFFIMAGE *pImage);
     int TIFF_getHeight(TIFFIMAGE *pImage);
     int TIFF_getLastError(TIFFIMAGE *pImage);
+    int TIFF_getPageCount(TIFFIMAGE *pImage);
+    int TIFF_openPage(TIFFIMAGE *pImage, int iPage);
+    void TIFF_rewind(TIFFIMAGE *pImage);
     int TIFF_addData(TIFFIMAGE *pPage, uint8_t *pData, int iLen);
     int TIFF_decode1Line(TIFFIMAGE *pImage, uint8_t *pCurrent, uint8_t *pPrevious);
+    void TIFF_setStripBuffer(TIFFIMAGE *pImage, uint8_t *pBuffer, int iSize);
+#ifdef TIFF_ARENA
+    int TIFF_getBufferSize(TIFFIMAGE *pImage);
+    void TIFF_setBuffer(TIFFIMAGE *pImage, uint8_t *pBuffer, int iSize);
+#endif
+#ifdef TIFF_THREADS
+    void TIFF_setThreads(TIFFIMAGE *pImage, int iThreads);
+    void TIFF_setReadAhead(TIFFIMAGE *pImage, int iBuffers);
+    int TIFF_decodePages(TIFFIMAGE *pImage, int iThreads);
+#endif
 #endif
 
-// Due to unaligned memory causing an exception, we have to do these macros the slow way
-#define TIFFMOTOLONG(p) (((uint32_t)(*p)<<24UL) + ((uint32_t)(*(p+1))<<16UL) + ((uint32_t)(*(p+2))<<8UL) + (uint32_t)(*(p+3)))
-#define TOP_BIT 0x80000000
-#define MAX_VALUE 0xffffffff
-#define LONGWHITECODEMASK 0x2000000
-#define LONGBLACKCODEMASK 0x10000000
-// Must be a 32-bit target processor
-#define REGISTER_WIDTH 32
+#define TOP_BIT ((BIGUINT)1 << (REGISTER_WIDTH-1))
+#define MAX_VALUE ((BIGUINT)-1)
+// the code masks are defined for a 32-bit word, move them to the top of the register
+#define LONGWHITECODEMASK ((BIGUINT)0x2000000 << (REGISTER_WIDTH-32))
+#define LONGBLACKCODEMASK ((BIGUINT)0x10000000 << (REGISTER_WIDTH-32))
 
 #define CLIMBWHITE_NEW(pBuf, ulBitOff, ulBits, sCode) \
     { uint32_t ul; int iLen = 64; sCode = 0; while (iLen > 63) \
     { if (ulBitOff > (REGISTER_WIDTH-17)) \
-      { pBuf += (ulBitOff>>3); ulBitOff &= 7; ulBits = TIFFMOTOLONG(pBuf); } \
+      { pBuf += (ulBitOff>>3); ulBitOff &= 7; ulBits = TIFFLOADBITS(pPage, pBuf); } \
       if ((ulBits << ulBitOff) < LONGWHITECODEMASK) \
                   { ul = (ulBits >> ((REGISTER_WIDTH-14) - ulBitOff)) & 0x3fe; ulBitOff += pgm_read_word(&black_l[ul]); iLen = pgm_read_word(&black_l[ul+1]);} \
                 else {ul = (ulBits >> ((REGISTER_WIDTH - 10) - ulBitOff)) & 0x3fe; ulBitOff += pgm_read_word(&white_s[ul]); iLen = pgm_read_word(&white_s[ul+1]);} \
@@ -222,10 +586,52 @@ int TIFF_openTIFFFile(TIFFIMAGE *pImage, const char *szFilename, TIFF_OPEN_CALLB
 #define CLIMBBLACK_NEW(pBuf, ulBitOff, ulBits, sCode) \
     { uint32_t ul; int iLen = 64; sCode = 0; while (iLen > 63) \
     { if (ulBitOff > (REGISTER_WIDTH-15)) \
-      { pBuf += (ulBitOff>>3); ulBitOff &= 7; ulBits = TIFFMOTOLONG(pBuf); } \
+      { pBuf += (ulBitOff>>3); ulBitOff &= 7; ulBits = TIFFLOADBITS(pPage, pBuf); } \
       if ((ulBits << ulBitOff) < LONGBLACKCODEMASK) \
          { ul = (ulBits >> ((REGISTER_WIDTH-14) - ulBitOff)) & 0x3fe; ulBitOff += pgm_read_word(&black_l[ul]); iLen = pgm_read_word(&black_l[ul+1]);} \
         else {ul = (ulBits >> ((REGISTER_WIDTH - 7) - ulBitOff)) & 0x7e; ulBitOff += pgm_read_word(&black_s[ul]); iLen = pgm_read_word(&black_s[ul+1]);} \
      sCode += iLen; }}
 
+#ifdef TIFF_WIDE_TABLES
+//
+// Wide table entries
+// mode table: bits 0-3 = length of 1st code, 4-7 = length of 2nd code,
+//             8-15 = 1st code (same values as code_table), 16-23 = 2nd code (0 = none)
+// run tables: bits 0-3 = total code length (0 = not in the table, use the slow path),
+//             bit 4 = makeup code only (another code follows), bits 8-31 = run length
+//
+#define WIDE_BITS 12
+#define WIDE_MASK ((1 << WIDE_BITS)-1)
+#define WIDE_RUN_MORE 0x10
+#define CLIMBWIDE(pTable, CLIMBSLOW, pBuf, ulBitOff, ulBits, sCode) \
+    { uint32_t ul; int32_t sSlow; sCode = 0; do \
+    { if (ulBitOff > (REGISTER_WIDTH-WIDE_BITS)) \
+      { pBuf += (ulBitOff>>3); ulBitOff &= 7; ulBits = TIFFLOADBITS(pPage, pBuf); } \
+      ul = pTable[(ulBits >> ((REGISTER_WIDTH-WIDE_BITS) - ulBitOff)) & WIDE_MASK]; \
+      if ((ul & 0xf) == 0) { CLIMBSLOW(pBuf, ulBitOff, ulBits, sSlow) \
+          sCode = (sSlow < 0) ? sSlow : sCode + sSlow; break; } \
+      ulBitOff += (ul & 0xf); sCode += (ul >> 8); \
+    } while (ul & WIDE_RUN_MORE); }
+#define CLIMBWHITE(pBuf, ulBitOff, ulBits, sCode) CLIMBWIDE(ulWhiteWide, CLIMBWHITE_NEW, pBuf, ulBitOff, ulBits, sCode)
+#define CLIMBBLACK(pBuf, ulBitOff, ulBits, sCode) CLIMBWIDE(ulBlackWide, CLIMBBLACK_NEW, pBuf, ulBitOff, ulBits, sCode)
+#define MODE_REFILL (REGISTER_WIDTH-WIDE_BITS)
+#else
+#define CLIMBWHITE CLIMBWHITE_NEW
+#define CLIMBBLACK CLIMBBLACK_NEW
+#define MODE_REFILL (REGISTER_WIDTH-8)
+#endif // TIFF_WIDE_TABLES
+//
+// A string of 1 bits is a string of V(0) codes. When the compiler has a
+// count-leading-zeros builtin, Decode_one_line() measures the whole string
+// at once and copies the matching reference flips as a block.
+//
+#if defined( __GNUC__ ) && !defined( __AVR__ ) && !defined( NO_RAM )
+#define TIFF_V0_BURST
+#if REGISTER_WIDTH == 64
+#define TIFF_CLZ(x) __builtin_clzll(x)
+#else
+#define TIFF_CLZ(x) __builtin_clz(x)
+#endif
+#endif
+
 #endif // __ONEBITGFX__
@@ -22,6 +22,23 @@
 #define REENTRANT
 
 #include "TIFF_G4.h"
+#ifdef TIFF_THREADS
+#include <pthread.h>
+#endif
+#ifdef TIFF_MMAP
+#include <sys/mman.h>
+#endif
+#if defined( TIFF_MMAP ) || defined( TIFF_PREAD )
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GNUC__
+#define TIFF_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define TIFF_ALWAYS_INLINE inline
+#endif
 
 // forward references
 #ifndef NO_RAM
@@ -31,7 +48,48 @@ static void TIFFGetMoreData(TIFFIMAGE *pPage);
 static int Decode(TIFFIMAGE *pImage);
 static int Decode_Inc(TIFFIMAGE *pPage, int bHasMoreData);
 static int Add_Data(TIFFIMAGE *pPage, uint8_t *pData, int iLen);
+static void TIFFSetCCITT(TIFFIMAGE *pImage, int iK, int iOptions, int iDamagedRows);
+static void TIFFSetScaleY(TIFFIMAGE *pImage, float yscale);
 static void Decode_Inc_Begin(TIFFIMAGE *pPage, int iWidth, int iHeight, uint8_t ucFillOrder, TIFF_DRAW_CALLBACK *pfnDraw);
+static int TIFFAllocBuffers(TIFFIMAGE *pPage);
+static int TIFFPageCount(TIFFIMAGE *pPage);
+static int TIFFOpenPage(TIFFIMAGE *pPage, int iPage);
+static void TIFFRewind(TIFFIMAGE *pPage);
+#ifdef TIFF_THREADS
+static int TIFFDecodePages(TIFFIMAGE *pPage, int iThreads);
+static int TIFFReadAheadBuffers(int iBuffers);
+#endif
+#ifdef TIFF_ARENA
+static int TIFFBufferSize(TIFFIMAGE *pPage);
+static void TIFFFreeBuffers(TIFFIMAGE *pPage);
+#endif
+static void Scale2Gray(uint8_t *source, int width, int iPitch);
+static void Scale2Gray4BPP(uint8_t *source, uint8_t *dest, int width, int iPitch);
+#ifdef TIFF_SIMD
+#include <immintrin.h>
+//
+// The per-line pixel kernels, selected at startup by TIFFInitKernels()
+//
+typedef struct tiff_kernels
+{
+    void (*pfnMirror)(uint8_t *pData, int iLen);
+    void (*pfnZeroFill)(uint8_t *pDest, int iLen);
+    void (*pfnScale2Gray)(uint8_t *source, int width, int iPitch);
+    void (*pfnScale2Gray4BPP)(uint8_t *source, uint8_t *dest, int width, int iPitch);
+    void (*pfnGray2Color)(uint8_t *pPixels, int iCount, const uint16_t *pColors);
+} TIFFKERNELS;
+static TIFFKERNELS TIFFKernels;
+#define TIFF_MIRROR(p, len) (*TIFFKernels.pfnMirror)(p, len)
+#define TIFF_ZERO_FILL(p, len) (*TIFFKernels.pfnZeroFill)(p, len)
+#define TIFF_SCALE2GRAY(s, w, pitch) (*TIFFKernels.pfnScale2Gray)(s, w, pitch)
+#define TIFF_SCALE2GRAY4BPP(s, d, w, pitch) (*TIFFKernels.pfnScale2Gray4BPP)(s, d, w, pitch)
+#define TIFF_GRAY2COLOR(p, count, colors) (*TIFFKernels.pfnGray2Color)(p, count, colors)
+#else
+#define TIFF_MIRROR TIFFMirror
+#define TIFF_SCALE2GRAY Scale2Gray
+#define TIFF_SCALE2GRAY4BPP Scale2Gray4BPP
+#define TIFF_GRAY2COLOR TIFFGray2Color
+#endif // TIFF_SIMD
 // Scale to gray tables
 //
 // Top 4 bits = top line, bottom 4 bits = bottom line
@@ -279,6 +337,94 @@ static const int16_t black_l[1024] PROGMEM =
      7,12,7,12,7,12,7,12,7,12,7,12,7,12,7,12,
      7,12,7,12,7,12,7,12,7,12,7,12,7,12,7,12,
      7,12,7,12,7,12,7,12,7,12,7,12,7,12,7,12};
+
+#ifdef TIFF_WIDE_TABLES
+//
+// Wide (WIDE_BITS) lookup tables for the mode codes and the run lengths
+// They're expanded from the tables above before main() runs, so decoders on
+// any thread can use them (see TIFF_G4.h for the entry layout)
+//
+static uint32_t ulModeWide[1 << WIDE_BITS];
+static uint32_t ulWhiteWide[1 << WIDE_BITS];
+static uint32_t ulBlackWide[1 << WIDE_BITS];
+//
+// Decode the mode code at the top of the given bits
+// the same way as Decode_one_line() does with code_table
+//
+static uint32_t WideModeCode(BIGUINT ulBits, int *pLen)
+{
+    uint32_t ul;
+
+    if (ulBits & TOP_BIT) { // V(0)
+        *pLen = 1;
+        return 0x10;
+    }
+    ul = (ulBits >> (REGISTER_WIDTH - 8)) & 0xfe;
+    *pLen = pgm_read_byte(&code_table[ul+1]);
+    return pgm_read_byte(&code_table[ul]);
+} /* WideModeCode() */
+//
+// Decode the run code at the top of the given bits
+// the same way as one pass of the CLIMB macros
+//
+static int32_t WideRunCode(BIGUINT ulBits, int bBlack, int *pLen)
+{
+    uint32_t ul;
+    const int16_t *pTable;
+
+    if (ulBits < (bBlack ? LONGBLACKCODEMASK : LONGWHITECODEMASK)) {
+        ul = (ulBits >> (REGISTER_WIDTH - 14)) & 0x3fe;
+        pTable = black_l;
+    } else if (bBlack) {
+        ul = (ulBits >> (REGISTER_WIDTH - 7)) & 0x7e;
+        pTable = black_s;
+    } else {
+        ul = (ulBits >> (REGISTER_WIDTH - 10)) & 0x3fe;
+        pTable = white_s;
+    }
+    *pLen = pgm_read_word(&pTable[ul]);
+    return pgm_read_word(&pTable[ul+1]);
+} /* WideRunCode() */
+
+static uint32_t WideRunEntry(BIGUINT ulBits, int bBlack)
+{
+    int iLen, iLen2;
+    int32_t iRun, iRun2;
+
+    iRun = WideRunCode(ulBits, bBlack, &iLen);
+    if (iLen < 2 || iLen > WIDE_BITS || iRun < 0)
+        return 0; // EOL, bad or long code; let the slow path deal with it
+    if (iRun < 64) // terminating code
+        return iLen | (iRun << 8);
+    // makeup code; merge the terminating code if it fits too
+    iRun2 = WideRunCode(ulBits << iLen, bBlack, &iLen2);
+    if (iLen2 >= 2 && iLen + iLen2 <= WIDE_BITS && iRun2 >= 0 && iRun2 < 64)
+        return (iLen + iLen2) | ((iRun + iRun2) << 8);
+    return iLen | WIDE_RUN_MORE | (iRun << 8);
+} /* WideRunEntry() */
+
+__attribute__((constructor))
+static void MakeWideTables(void)
+{
+    int i, iLen, iLen2;
+    BIGUINT ulBits;
+    uint32_t ulCode, ulCode2;
+
+    for (i=0; i<(1 << WIDE_BITS); i++) {
+        ulBits = (BIGUINT)i << (REGISTER_WIDTH - WIDE_BITS);
+        ulWhiteWide[i] = WideRunEntry(ulBits, 0);
+        ulBlackWide[i] = WideRunEntry(ulBits, 1);
+        ulCode = WideModeCode(ulBits, &iLen);
+        ulModeWide[i] = iLen | (ulCode << 8);
+        // a vertical code can be followed by a second one in the same probe
+        if (ulCode <= 3 || (ulCode & 0xf0) == 0x10) {
+            ulCode2 = WideModeCode(ulBits << iLen, &iLen2);
+            if ((ulCode2 <= 3 || (ulCode2 & 0xf0) == 0x10) && iLen2 && (iLen + iLen2) <= WIDE_BITS)
+                ulModeWide[i] |= (iLen2 << 4) | (ulCode2 << 16);
+        }
+    }
+} /* MakeWideTables() */
+#endif // TIFF_WIDE_TABLES
 //
 // Helper functions for memory based images
 //
@@ -297,7 +443,7 @@ static int32_t readMem(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen)
     return iBytesRead;
 } /* readMem() */
 
-static int32_t seekMem(TIFFFILE *pFile, int32_t iPosition)
+static TIFF_OFFSET seekMem(TIFFFILE *pFile, TIFF_OFFSET iPosition)
 {
     if (iPosition < 0) iPosition = 0;
     else if (iPosition >= pFile->iSize) iPosition = pFile->iSize-1;
@@ -307,17 +453,61 @@ static int32_t seekMem(TIFFFILE *pFile, int32_t iPosition)
 #endif // NO_RAM
 
 #if (defined( __LINUX__ ) || defined( __MCUXPRESSO )) && !defined (NO_RAM)
+#ifdef TIFF_PREAD
+//
+// The handle is the file descriptor + 1 (so that it isn't NULL) and the file
+// position is only kept in the TIFFFILE; there's no shared offset to seek
+//
+#define TIFF_FD(handle) ((int)(intptr_t)(handle) - 1)
+
+static void closeFile(void *handle)
+{
+    close(TIFF_FD(handle));
+} /* closeFile() */
+
+static TIFF_OFFSET seekFile(TIFFFILE *pFile, TIFF_OFFSET iPosition)
+{
+    if (iPosition < 0) iPosition = 0;
+    else if (iPosition >= pFile->iSize) iPosition = pFile->iSize-1;
+    pFile->iPos = iPosition;
+    return iPosition;
+} /* seekFile() */
+
+static int32_t readFile(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen)
+{
+    int32_t iBytesRead, iTotal = 0;
+
+    if ((pFile->iSize - pFile->iPos) < iLen)
+       iLen = (int32_t)(pFile->iSize - pFile->iPos);
+    while (iTotal < iLen) // pread() can return less than asked for
+    {
+       iBytesRead = (int32_t)pread(TIFF_FD(pFile->fHandle), &pBuf[iTotal], iLen - iTotal, (off_t)(pFile->iPos + iTotal));
+       if (iBytesRead <= 0)
+          break;
+       iTotal += iBytesRead;
+    }
+    pFile->iPos += iTotal;
+    return iTotal;
+} /* readFile() */
+#else
+#ifdef __LINUX__ // 64-bit file positions
+#define TIFF_FSEEK(f, pos, whence) fseeko(f, (off_t)(pos), whence)
+#define TIFF_FTELL(f) (TIFF_OFFSET)ftello(f)
+#else
+#define TIFF_FSEEK(f, pos, whence) fseek(f, (long)(pos), whence)
+#define TIFF_FTELL(f) (TIFF_OFFSET)ftell(f)
+#endif
 static void closeFile(void *handle)
 {
     fclose((FILE *)handle);
 } /* closeFile() */
 
-static int32_t seekFile(TIFFFILE *pFile, int32_t iPosition)
+static TIFF_OFFSET seekFile(TIFFFILE *pFile, TIFF_OFFSET iPosition)
 {
     if (iPosition < 0) iPosition = 0;
     else if (iPosition >= pFile->iSize) iPosition = pFile->iSize-1;
     pFile->iPos = iPosition;
-    fseek((FILE *)pFile->fHandle, iPosition, SEEK_SET);
+    TIFF_FSEEK((FILE *)pFile->fHandle, iPosition, SEEK_SET);
     return iPosition;
 } /* seekFile() */
 
@@ -334,8 +524,89 @@ static int32_t readFile(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen)
     pFile->iPos += iBytesRead;
     return iBytesRead;
 } /* readFile() */
+#endif // TIFF_PREAD
 #endif // __LINUX__
 
+#if defined( TIFF_MMAP ) && !defined( __cplusplus )
+//
+// The handle of a mapped file is its TIFFFILE, which has the address and size
+//
+static void unmapFile(void *handle)
+{
+    TIFFFILE *pFile = (TIFFFILE *)handle;
+
+    munmap(pFile->pData, (size_t)pFile->iSize);
+} /* unmapFile() */
+
+//
+// Map an open regular file read-only and set it up to be read with readMem()
+// returns 0 if the file can't be mapped (it's read from fd instead)
+// Files which fit in ucFileBuf are read whole by a single read, which costs
+// less than setting up and tearing down a mapping, so they aren't mapped
+//
+static int mapFile(TIFFIMAGE *pImage, int fd, struct stat *pStat)
+{
+    void *pMap;
+
+    if (!S_ISREG(pStat->st_mode) || pStat->st_size <= TIFF_FILE_BUF_SIZE || (uint64_t)pStat->st_size > (uint64_t)(size_t)-1)
+        return 0;
+    pMap = mmap(NULL, (size_t)pStat->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pMap == MAP_FAILED)
+        return 0;
+    close(fd); // the mapping keeps the file open
+    madvise(pMap, (size_t)pStat->st_size, MADV_SEQUENTIAL);
+    pImage->pfnRead = readMem;
+    pImage->pfnSeek = seekMem;
+    pImage->pfnClose = unmapFile;
+    pImage->TIFFFile.pData = (uint8_t *)pMap;
+    pImage->TIFFFile.iSize = (TIFF_OFFSET)pStat->st_size;
+    pImage->TIFFFile.fHandle = &pImage->TIFFFile;
+    return 1;
+} /* mapFile() */
+#endif // TIFF_MMAP
+
+#if defined( TIFF_PREAD ) && !defined( __cplusplus )
+//
+// The handle of a loaded file is its TIFFFILE, like a mapped one
+//
+static void freeFile(void *handle)
+{
+    free(((TIFFFILE *)handle)->pData);
+} /* freeFile() */
+
+//
+// Read a small regular file whole with one pread() and set it up to be read
+// with readMem(); the tags and strip arrays would take many tiny reads
+// returns 0 if the file is read from fd instead
+//
+static int loadFile(TIFFIMAGE *pImage, int fd, struct stat *pStat)
+{
+    TIFFFILE file;
+
+    if (!S_ISREG(pStat->st_mode) || pStat->st_size <= 0 || pStat->st_size > TIFF_FILE_BUF_SIZE)
+        return 0;
+    file.pData = (uint8_t *)malloc((size_t)pStat->st_size);
+    if (file.pData == NULL)
+        return 0;
+    file.fHandle = (void *)(intptr_t)(fd + 1);
+    file.iSize = (TIFF_OFFSET)pStat->st_size;
+    file.iPos = 0;
+    if (readFile(&file, file.pData, (int32_t)file.iSize) != file.iSize)
+    {
+        free(file.pData);
+        return 0;
+    }
+    close(fd);
+    pImage->pfnRead = readMem;
+    pImage->pfnSeek = seekMem;
+    pImage->pfnClose = freeFile;
+    pImage->TIFFFile.pData = file.pData;
+    pImage->TIFFFile.iSize = file.iSize;
+    pImage->TIFFFile.fHandle = &pImage->TIFFFile;
+    return 1;
+} /* loadFile() */
+#endif // TIFF_PREAD
+
 #ifndef __cplusplus
 //
 // C API
@@ -357,18 +628,51 @@ int TIFF_openTIFFRAM(TIFFIMAGE *pImage, uint8_t *pData, int iDatasize, TIFF_DRAW
 #ifdef __LINUX__
 int TIFF_openTIFFFile(TIFFIMAGE *pImage, const char *szFilename, TIFF_DRAW_CALLBACK *pfnDraw)
 {
+#if defined( TIFF_MMAP ) || defined( TIFF_PREAD )
+    struct stat st;
+    int fd;
+#endif
+
     memset(pImage, 0, sizeof(TIFFIMAGE));
+    pImage->pfnDraw = pfnDraw;
+#if defined( TIFF_MMAP ) || defined( TIFF_PREAD )
+    fd = open(szFilename, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+#ifdef TIFF_MMAP
+    if (mapFile(pImage, fd, &st))
+        return TIFFInit(pImage);
+#endif
+#ifdef TIFF_PREAD
+    if (loadFile(pImage, fd, &st))
+        return TIFFInit(pImage);
+    pImage->pfnRead = readFile;
+    pImage->pfnSeek = seekFile;
+    pImage->pfnClose = closeFile;
+    pImage->TIFFFile.fHandle = (void *)(intptr_t)(fd + 1);
+    pImage->TIFFFile.iSize = (TIFF_OFFSET)st.st_size;
+    return TIFFInit(pImage);
+#else
+    close(fd); // read with stdio
+#endif
+#endif // TIFF_MMAP || TIFF_PREAD
+#ifndef TIFF_PREAD
     pImage->pfnRead = readFile;
     pImage->pfnSeek = seekFile;
-    pImage->pfnDraw = pfnDraw;
     pImage->pfnClose = closeFile;
-    pImage->TIFFFile.fHandle = fopen(szFilename, "r+b");
+    pImage->TIFFFile.fHandle = fopen(szFilename, "rb");
     if (pImage->TIFFFile.fHandle == NULL)
        return 0;
-    fseek((FILE *)pImage->TIFFFile.fHandle, 0, SEEK_END);
-    pImage->TIFFFile.iSize = (int)ftell((FILE *)pImage->TIFFFile.fHandle);
-    fseek((FILE *)pImage->TIFFFile.fHandle, 0, SEEK_SET);
+    TIFF_FSEEK((FILE *)pImage->TIFFFile.fHandle, 0, SEEK_END);
+    pImage->TIFFFile.iSize = TIFF_FTELL((FILE *)pImage->TIFFFile.fHandle);
+    TIFF_FSEEK((FILE *)pImage->TIFFFile.fHandle, 0, SEEK_SET);
     return TIFFInit(pImage);
+#endif
 
 } /* openTIFFFile() */
 #else
@@ -392,8 +696,44 @@ void TIFF_close(TIFFIMAGE *pImage)
 {
     if (pImage->pfnClose)
         (*pImage->pfnClose)(pImage->TIFFFile.fHandle);
+#ifdef TIFF_ARENA
+    TIFFFreeBuffers(pImage);
+#endif
 } /* close() */
 
+#ifdef TIFF_ARENA
+int TIFF_getBufferSize(TIFFIMAGE *pImage)
+{
+    return TIFFBufferSize(pImage);
+} /* getBufferSize() */
+
+void TIFF_setBuffer(TIFFIMAGE *pImage, uint8_t *pBuffer, int iSize)
+{
+    pImage->pArena = pBuffer;
+    pImage->iArenaSize = iSize;
+} /* setBuffer() */
+#endif // TIFF_ARENA
+#ifdef TIFF_THREADS
+//
+// Decode the strips of multi-strip images on this many worker threads
+// (call after opening the image, 0 = don't use threads)
+//
+void TIFF_setThreads(TIFFIMAGE *pImage, int iThreads)
+{
+    if (iThreads < 0) iThreads = 0;
+    if (iThreads > TIFF_MAX_THREADS) iThreads = TIFF_MAX_THREADS;
+    pImage->iThreads = iThreads;
+} /* setThreads() */
+//
+// Read the compressed data of a file ahead of the decoder into this many
+// buffers on a background thread (call after opening the image, 0 = don't)
+//
+void TIFF_setReadAhead(TIFFIMAGE *pImage, int iBuffers)
+{
+    pImage->iReadAhead = TIFFReadAheadBuffers(iBuffers);
+} /* setReadAhead() */
+#endif // TIFF_THREADS
+
 void TIFF_setDrawParameters(TIFFIMAGE *pImage, float scale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf)
 {
     pImage->window.iScale = (uint32_t)(scale * 65536.0f); // convert to uint32
@@ -403,8 +743,17 @@ void TIFF_setDrawParameters(TIFFIMAGE *pImage, float scale, int iPixelType, int
     pImage->window.iHeight = iHeight;
     pImage->window.p4BPP = p4BPPBuf; // user-supplied buffer for 4-bpp grayscale output
     pImage->window.ucPixelType = (uint8_t)iPixelType;
-
+    pImage->window.iScaleY = pImage->window.iScale;
 } /* setDrawParameters() */
+//
+// Separate horizontal and vertical scales
+// A yscale of 0 corrects the aspect ratio with the resolution tags
+//
+void TIFF_setDrawParametersXY(TIFFIMAGE *pImage, float xscale, float yscale, int iPixelType, int iStartX, int iStartY, int iWidth, int iHeight, uint8_t *p4BPPBuf)
+{
+    TIFF_setDrawParameters(pImage, xscale, iPixelType, iStartX, iStartY, iWidth, iHeight, p4BPPBuf);
+    TIFFSetScaleY(pImage, yscale);
+} /* setDrawParametersXY() */
 
 #endif // NO_RAM
 
@@ -414,7 +763,12 @@ int TIFF_openRAW(TIFFIMAGE *pImage, int iWidth, int iHeight, int iFillOrder, uin
     (void)pfnDraw;
     pImage->iVLCSize = iDataSize;
     pImage->pSrc = pImage->pBuf = pData;
-    pImage->ulBits = TIFFMOTOLONG(pData); // preload the first 32 bits of data
+    pImage->ulBits = TIFFMOTOLONG(pData); // preload the bit accumulator
+    pImage->ulBitOff = 0;
+#ifdef TIFF_FLIP_CACHE
+    pImage->cache.sCount[0] = pImage->cache.sCount[1] = -1; // no reference line yet
+    pImage->cache.ucCur = 0;
+#endif
 #else
     memset(pImage, 0, sizeof(TIFFIMAGE));
     pImage->pfnRead = readMem;
@@ -424,22 +778,30 @@ int TIFF_openRAW(TIFFIMAGE *pImage, int iWidth, int iHeight, int iFillOrder, uin
     pImage->pfnClose = NULL;
     pImage->TIFFFile.iSize = iDataSize;
     pImage->TIFFFile.pData = pData;
-#endif // NO_RAM
-    pImage->iWidth = iWidth;
-    pImage->iHeight = iHeight;
-    pImage->ucFillOrder = (uint8_t)iFillOrder;
     // Default output values
-    pImage->window.iScale = 65536; // 1.0 scale
+    pImage->window.iScale = pImage->window.iScaleY = 65536; // 1.0 scale
     pImage->window.x = 0;
     pImage->window.y = 0; // upper left corner of interest (source pixels)
     pImage->window.iWidth = iWidth; // dest window size
     pImage->window.iHeight = iHeight;
     pImage->window.ucPixelType = TIFF_PIXEL_1BPP;
+    pImage->iRowsPerStrip = iHeight; // a single strip
+#endif // NO_RAM
+    pImage->iWidth = iWidth;
+    pImage->iHeight = iHeight;
+    pImage->ucFillOrder = (uint8_t)iFillOrder;
     return 1;
 
 } /* openRAW() */
 
 #ifndef NO_RAM
+int TIFF_openCCITT(TIFFIMAGE *pImage, int iWidth, int iHeight, int iK, int iOptions, int iDamagedRows, uint8_t *pData, int iDataSize, TIFF_DRAW_CALLBACK *pfnDraw)
+{
+    TIFF_openRAW(pImage, iWidth, iHeight, BITDIR_MSB_FIRST, pData, iDataSize, pfnDraw);
+    TIFFSetCCITT(pImage, iK, iOptions, iDamagedRows);
+    return 1;
+} /* TIFF_openCCITT() */
+
 int TIFF_decode(TIFFIMAGE *pImage)
 {
     return Decode(pImage);
@@ -467,6 +829,46 @@ int TIFF_getHeight(TIFFIMAGE *pImage)
 {
     return pImage->iHeight;
 } /* getHeight() */
+//
+// Multi-page files
+// Pages are numbered from 0; openPage() parses the page and resets the draw
+// parameters like openTIFF() does for the first one
+//
+int TIFF_getPageCount(TIFFIMAGE *pImage)
+{
+    return TIFFPageCount(pImage);
+} /* getPageCount() */
+
+int TIFF_openPage(TIFFIMAGE *pImage, int iPage)
+{
+    return TIFFOpenPage(pImage, iPage);
+} /* openPage() */
+//
+// Get ready to decode the current page again (e.g. another icon of a
+// sprite sheet) without opening and parsing the file again
+//
+void TIFF_rewind(TIFFIMAGE *pImage)
+{
+    TIFFRewind(pImage);
+} /* rewind() */
+//
+// Read the strips into this buffer (call after opening the image)
+//
+void TIFF_setStripBuffer(TIFFIMAGE *pImage, uint8_t *pBuffer, int iSize)
+{
+    pImage->pStripBuf = pBuffer;
+    pImage->iStripBufSize = iSize;
+} /* setStripBuffer() */
+#ifdef TIFF_THREADS
+//
+// Decode all of the pages on iThreads threads
+// with the pixel type and scale of setDrawParameters()
+//
+int TIFF_decodePages(TIFFIMAGE *pImage, int iThreads)
+{
+    return TIFFDecodePages(pImage, iThreads);
+} /* decodePages() */
+#endif // TIFF_THREADS
 #endif // NO_RAM
 
 int TIFF_getLastError(TIFFIMAGE *pImage)
@@ -521,6 +923,33 @@ static uint32_t TIFFLONG(unsigned char *p, int bMotorola)
     return l;
 } /* TIFFLONG() */
 //
+// TIFFLONG64
+// read a 64-bit unsigned integer (BigTIFF)
+//
+static uint64_t TIFFLONG64(unsigned char *p, int bMotorola)
+{
+    uint64_t hi, lo;
+
+    if (bMotorola)
+    {
+        hi = TIFFLONG(p, 1);
+        lo = TIFFLONG(p+4, 1);
+    }
+    else
+    {
+        lo = TIFFLONG(p, 0);
+        hi = TIFFLONG(p+4, 0);
+    }
+    return (hi << 32) | lo;
+} /* TIFFLONG64() */
+//
+// A file offset which doesn't fit in TIFF_OFFSET becomes -1 (invalid)
+//
+static TIFF_OFFSET TIFFOffset(uint64_t u64)
+{
+    return (u64 > (uint64_t)TIFF_OFFSET_MAX) ? -1 : (TIFF_OFFSET)u64;
+} /* TIFFOffset() */
+//
 // TIFFVALUE
 // read an integer value encoded in a TIFF TAG (12-byte structure)
 // and interpret the data as big endian (Motorola) or little endian (Intel)
@@ -560,107 +989,297 @@ static int TIFFVALUE(unsigned char *p, int bMotorola)
     
 } /* TIFFVALUE() */
 
-static int TIFFParseInfo(TIFFIMAGE *pPage)
+//
+// The number of values of a tag (0 if there are too many)
+//
+static int TIFFTagCount(TIFFIMAGE *pPage, unsigned char *p)
+{
+    uint64_t u64Count;
+
+    if (pPage->ucBigTIFF)
+        u64Count = TIFFLONG64(p+4, pPage->ucMotorola);
+    else
+        u64Count = TIFFLONG(p+4, pPage->ucMotorola);
+    return (u64Count > 0x7fffffff) ? 0 : (int)u64Count;
+} /* TIFFTagCount() */
+//
+// Remember where the values of a StripOffsets or StripByteCounts tag are
+//
+static void TIFFGetTagArray(TIFFIMAGE *pPage, unsigned char *p, TIFFTAGARRAY *pArray)
+{
+    int iType = TIFFSHORT(p+2, pPage->ucMotorola);
+
+    if (iType == 3 || iType == 16) // SHORT or LONG8
+        pArray->ucType = (uint8_t)iType;
+    else
+        pArray->ucType = 4; // LONG
+    if (pPage->ucBigTIFF)
+        memcpy(pArray->ucValue, p+12, 8);
+    else
+        memcpy(pArray->ucValue, p+8, 4);
+} /* TIFFGetTagArray() */
+//
+// Read one entry of a strip array
+//
+static uint64_t TIFFArrayValue(TIFFIMAGE *pPage, TIFFTAGARRAY *pArray, int iIndex)
+{
+    uint8_t ucTemp[8], *p;
+    int iSize = (pArray->ucType == 3) ? 2 : (pArray->ucType == 16) ? 8 : 4;
+    int iInline = pPage->ucBigTIFF ? 8 : 4; // bytes of values which fit in the tag
+    TIFF_OFFSET iOffset;
+
+    if (pPage->iStripCount > iInline / iSize) // the array is somewhere else in the file
+    {
+        if (pPage->ucBigTIFF)
+            iOffset = TIFFOffset(TIFFLONG64(pArray->ucValue, pPage->ucMotorola));
+        else
+            iOffset = TIFFOffset(TIFFLONG(pArray->ucValue, pPage->ucMotorola));
+        if (iOffset < 0 || iOffset > pPage->TIFFFile.iSize - iSize - (TIFF_OFFSET)iIndex * iSize)
+            return 0;
+        (*pPage->pfnSeek)(&pPage->TIFFFile, iOffset + (TIFF_OFFSET)iIndex * iSize);
+        if ((*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, iSize) != iSize)
+            return 0;
+        p = ucTemp;
+    }
+    else
+    {
+        p = &pArray->ucValue[iIndex * iSize];
+    }
+    if (iSize == 2)
+        return TIFFSHORT(p, pPage->ucMotorola);
+    if (iSize == 4)
+        return TIFFLONG(p, pPage->ucMotorola);
+    return TIFFLONG64(p, pPage->ucMotorola);
+} /* TIFFArrayValue() */
+//
+// Set iStripOffset and iStripSize for the given strip
+//
+static void TIFFGetStrip(TIFFIMAGE *pPage, int iStrip)
+{
+    uint64_t u64Size = 0;
+
+    if (!pPage->StripOffsets.ucType) // openRAW(), the data starts at 0
+        return;
+    pPage->iStripOffset = TIFFOffset(TIFFArrayValue(pPage, &pPage->StripOffsets, iStrip));
+    if (pPage->StripSizes.ucType)
+        u64Size = TIFFArrayValue(pPage, &pPage->StripSizes, iStrip);
+    pPage->iStripSize = (u64Size > 0x7fffffff) ? 0x7fffffff : (int)u64Size;
+} /* TIFFGetStrip() */
+//
+// Read a RATIONAL tag value (remembered by TIFFGetTagArray())
+// returns it in 16:16 fixed point or 0 if it's missing or invalid
+//
+static uint32_t TIFFRational(TIFFIMAGE *pPage, TIFFTAGARRAY *pTag)
+{
+    uint8_t ucTemp[8], *p = pTag->ucValue;
+    uint32_t u32Num, u32Den;
+    uint64_t u64Value;
+    TIFF_OFFSET iOffset;
+
+    if (!pTag->ucType)
+        return 0;
+    if (!pPage->ucBigTIFF) // 8 bytes don't fit in a classic tag
+    {
+        iOffset = TIFFOffset(TIFFLONG(pTag->ucValue, pPage->ucMotorola));
+        if (iOffset < 0 || iOffset > pPage->TIFFFile.iSize - 8)
+            return 0;
+        (*pPage->pfnSeek)(&pPage->TIFFFile, iOffset);
+        if ((*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, 8) != 8)
+            return 0;
+        p = ucTemp;
+    }
+    u32Num = TIFFLONG(p, pPage->ucMotorola);
+    u32Den = TIFFLONG(p+4, pPage->ucMotorola);
+    if (u32Den == 0)
+        return 0;
+    u64Value = ((uint64_t)u32Num << 16) / u32Den;
+    return (u64Value > 0xffffffff) ? 0 : (uint32_t)u64Value;
+} /* TIFFRational() */
+
+//
+// Parse the IFD (tags) of one page
+//
+static int TIFFParseIFD(TIFFIMAGE *pPage, TIFF_OFFSET IFD)
 {
     int iBytesRead;
-    int i;
-    uint8_t bMotorola, *s = pPage->ucFileBuf;
+    int i, iTagSize, iChunk;
+    uint8_t bMotorola = pPage->ucMotorola, *s = pPage->ucFileBuf, *t, ucTag[TIFF_TAG_SIZE];
     uint16_t usTagCount;
-    int iStripCount, IFD, iTag, iBpp = 1, iSamples = 1;
+    int iTag, iBpp = 1, iSamples = 1;
+    TIFFTAGARRAY XRes, YRes; // read after the tags, the values are elsewhere in the file
 //    int iT6Options = 0;
 
+    // forget the previous page
+    pPage->iWidth = pPage->iHeight = 0;
+    pPage->ucCompression = pPage->ucPhotometric = pPage->ucT4Options = 0;
+    pPage->ucAligned = pPage->ucCCITT = 0;
+    pPage->iMaxDamagedRows = -1; // damaged G3 lines are always replaced
     pPage->ucFillOrder = BITDIR_MSB_FIRST; // default to MSB first
-    iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, 8);
-    if (iBytesRead != 8)
+    pPage->iStripCount = pPage->iRowsPerStrip = 0;
+    pPage->iStripOffset = pPage->iStripSize = 0;
+    pPage->iTileWidth = pPage->iTileHeight = 0;
+    memset(&pPage->StripOffsets, 0, sizeof(TIFFTAGARRAY));
+    memset(&pPage->StripSizes, 0, sizeof(TIFFTAGARRAY));
+    memset(&XRes, 0, sizeof(TIFFTAGARRAY));
+    memset(&YRes, 0, sizeof(TIFFTAGARRAY));
+    iTagSize = pPage->ucBigTIFF ? TIFF_BIGTAG_SIZE : TIFF_TAG_SIZE;
+    if (IFD < 8 || IFD > pPage->TIFFFile.iSize - (8 + 4*iTagSize)) // bad value
     {
         pPage->iError = TIFF_INVALID_FILE;
         return 0;
     }
-    if (s[0] != s[1] || (s[0] != 'M' && s[0] != 'I'))
-    {
-        pPage->iError = TIFF_INVALID_FILE;
-        return 0; // not a TIFF file
-    }
-    bMotorola = (s[0] == 'M');
-    IFD = TIFFLONG(&s[4], bMotorola); // get IFD
-    if (IFD > pPage->TIFFFile.iSize - (2 + 4*TIFF_TAG_SIZE)) // bad value
+    (*pPage->pfnSeek)(&pPage->TIFFFile, IFD);
+    if (pPage->ucBigTIFF) // 64-bit tag count
     {
-        pPage->iError = TIFF_INVALID_FILE;
-        return 0;
+        iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, 8);
+        usTagCount = (iBytesRead == 8 && TIFFLONG64(s, bMotorola) <= MAX_TIFF_TAGS) ? (uint16_t)TIFFLONG64(s, bMotorola) : 0;
     }
-    (*pPage->pfnSeek)(&pPage->TIFFFile, IFD);
-    iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, 2); // get tag count
-    usTagCount = TIFFSHORT(s, bMotorola);
-    if (iBytesRead != 2 || usTagCount < 4 || usTagCount > MAX_TIFF_TAGS)
+    else
     {
-        pPage->iError = TIFF_INVALID_FILE; // something corrupt/wrong
-        return 0;
+        iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, 2); // get tag count
+        usTagCount = (iBytesRead == 2) ? TIFFSHORT(s, bMotorola) : 0;
     }
-    // read just enough for the tag data
-    iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, TIFF_TAG_SIZE * usTagCount);
-    if (iBytesRead != usTagCount * TIFF_TAG_SIZE)
+    if (usTagCount < 4 || usTagCount > MAX_TIFF_TAGS)
     {
         pPage->iError = TIFF_INVALID_FILE; // something corrupt/wrong
         return 0;
     }
+    iChunk = TIFF_FILE_BUF_SIZE / iTagSize; // tags which fit in the buffer
     for (i=0; i<usTagCount; i++)
     {
-        iTag = TIFFSHORT(s, bMotorola);
+        if ((i % iChunk) == 0) // read the next group of tags
+        {
+            iBytesRead = usTagCount - i;
+            if (iBytesRead > iChunk)
+                iBytesRead = iChunk;
+            iBytesRead *= iTagSize;
+            s = pPage->ucFileBuf;
+            if ((*pPage->pfnRead)(&pPage->TIFFFile, s, iBytesRead) != iBytesRead)
+            {
+                pPage->iError = TIFF_INVALID_FILE; // something corrupt/wrong
+                return 0;
+            }
+        }
+        t = s;
+        if (pPage->ucBigTIFF) // a classic tag for TIFFVALUE() (a value which fits is left justified)
+        {
+            memcpy(ucTag, s, 4); // tag and type
+            memcpy(&ucTag[4], &s[bMotorola ? 8 : 4], 4); // low 32 bits of the count
+            memcpy(&ucTag[8], &s[12], 4);
+            t = ucTag;
+        }
+        iTag = TIFFSHORT(t, bMotorola);
         switch (iTag)
         {
             case 256: // width
-                pPage->iWidth = TIFFVALUE(s, bMotorola);
+                pPage->iWidth = TIFFVALUE(t, bMotorola);
                 break;
             case 257: // height
-                pPage->iHeight = TIFFVALUE(s, bMotorola);
+                pPage->iHeight = TIFFVALUE(t, bMotorola);
                 break;
             case 258: // bits per sample
-                iBpp = TIFFVALUE(s, bMotorola);
+                iBpp = TIFFVALUE(t, bMotorola);
                 break;
             case 259: // compression
-                pPage->ucCompression = (uint8_t)TIFFVALUE(s, bMotorola);
+                pPage->ucCompression = (uint8_t)TIFFVALUE(t, bMotorola);
                 break;
             case 262: // photometric value
-                pPage->ucPhotometric = (uint8_t)TIFFVALUE(s, bMotorola);
+                pPage->ucPhotometric = (uint8_t)TIFFVALUE(t, bMotorola);
                 break;
             case 266: // fill order
-                pPage->ucFillOrder = (uint8_t)TIFFVALUE(s, bMotorola);
+                pPage->ucFillOrder = (uint8_t)TIFFVALUE(t, bMotorola);
                 break;
-            case 273: // strip info
-                pPage->iStripOffset = TIFFVALUE(s, bMotorola);
-                iStripCount = TIFFLONG(s + 4, bMotorola);
-                if (iStripCount != 1)
-                { // single strip files only (for now)
-                    pPage->iError = TIFF_UNSUPPORTED_FEATURE;
-                    return 0;
-                }
+            case 273: // strip offsets
+                pPage->iStripCount = TIFFTagCount(pPage, s);
+                TIFFGetTagArray(pPage, s, &pPage->StripOffsets);
                 break;
             case 277: // samples per pixel
-                iSamples = TIFFVALUE(s, bMotorola);
+                iSamples = TIFFVALUE(t, bMotorola);
                 break;
             case 278: // rows per strip
-                //iRowsPerStrip = TIFFVALUE(s, bMotorola);
+                pPage->iRowsPerStrip = TIFFVALUE(t, bMotorola);
                 break;
-            case 279: // strip size
-                pPage->iStripSize = TIFFVALUE(s, bMotorola);
+            case 279: // strip sizes
+                TIFFGetTagArray(pPage, s, &pPage->StripSizes);
+                break;
+            case 282: // XResolution
+                TIFFGetTagArray(pPage, s, &XRes);
+                break;
+            case 283: // YResolution
+                TIFFGetTagArray(pPage, s, &YRes);
+                break;
+            case 292: // T4 options
+                pPage->ucT4Options = (uint8_t)TIFFVALUE(t, bMotorola);
+                break;
+            case 322: // tile width
+                pPage->iTileWidth = TIFFVALUE(t, bMotorola);
+                break;
+            case 323: // tile length
+                pPage->iTileHeight = TIFFVALUE(t, bMotorola);
+                break;
+            case 324: // tile offsets (kept with the strip offsets)
+                pPage->iStripCount = TIFFTagCount(pPage, s);
+                TIFFGetTagArray(pPage, s, &pPage->StripOffsets);
+                break;
+            case 325: // tile sizes
+                TIFFGetTagArray(pPage, s, &pPage->StripSizes);
                 break;
 //            case 293: // T6 option flags
-//                iT6Options = TIFFVALUE(s, bMotorola);
+//                iT6Options = TIFFVALUE(t, bMotorola);
 //                break;
         } // while
-        s += TIFF_TAG_SIZE;
+        s += iTagSize;
     }
     if (iSamples * iBpp != 1) // we only support 1-bpp images
     {
         pPage->iError = TIFF_UNSUPPORTED_FEATURE;
         return 0;
     }
-    if (pPage->iWidth > MAX_IMAGE_WIDTH) {
+    if (pPage->ucCompression < TIFF_COMPRESSION_CCITT_RLE || pPage->ucCompression > TIFF_COMPRESSION_CCITT_T6)
+    {
+        pPage->iError = TIFF_UNSUPPORTED_FEATURE; // only the CCITT fax codings
+        return 0;
+    }
+    if (pPage->ucCompression == TIFF_COMPRESSION_CCITT_RLE)
+        pPage->ucAligned = 1; // each line starts on a byte boundary
+    if (pPage->iWidth > TIFF_MAX_WIDTH) {
         pPage->iError = TIFF_TOO_WIDE;
         return 0;
     }
+    if (pPage->iTileWidth || pPage->iTileHeight) // tiled image
+    {
+#ifdef TIFF_TILES
+        // each tile must have an offset and a size
+        if (pPage->iTileWidth <= 0 || pPage->iTileHeight <= 0 || pPage->iTileWidth > TIFF_MAX_WIDTH ||
+            pPage->iWidth <= 0 || pPage->iHeight <= 0 || !pPage->StripOffsets.ucType || !pPage->StripSizes.ucType ||
+            (int64_t)((pPage->iWidth + pPage->iTileWidth - 1) / pPage->iTileWidth) * ((pPage->iHeight + pPage->iTileHeight - 1) / pPage->iTileHeight) > pPage->iStripCount)
+        {
+            pPage->iError = TIFF_INVALID_FILE;
+            return 0;
+        }
+        pPage->iRowsPerStrip = pPage->iTileHeight;
+#else
+        pPage->iError = TIFF_UNSUPPORTED_FEATURE;
+        return 0;
+#endif
+    }
+    else
+    {
+        if (pPage->iRowsPerStrip <= 0 || pPage->iRowsPerStrip > pPage->iHeight)
+            pPage->iRowsPerStrip = pPage->iHeight; // missing means a single strip
+        // each strip must have an offset (and a size if they're given)
+        if (pPage->iStripCount < 1 || !pPage->StripOffsets.ucType || pPage->iHeight <= 0 ||
+            (pPage->iHeight + pPage->iRowsPerStrip - 1) / pPage->iRowsPerStrip > pPage->iStripCount)
+        {
+            pPage->iError = TIFF_INVALID_FILE;
+            return 0;
+        }
+    }
+    TIFFGetStrip(pPage, 0);
+    pPage->u32XRes = TIFFRational(pPage, &XRes);
+    pPage->u32YRes = TIFFRational(pPage, &YRes);
     // Default output values
-    pPage->window.iScale = 65536; // 1.0 scale
+    pPage->window.iScale = pPage->window.iScaleY = 65536; // 1.0 scale
     pPage->window.x = 0;
     pPage->window.y = 0; // upper left corner of interest (source pixels)
     pPage->window.iWidth = pPage->iWidth; // dest window size
@@ -668,109 +1287,350 @@ static int TIFFParseInfo(TIFFIMAGE *pPage)
     pPage->window.ucPixelType = TIFF_PIXEL_1BPP;
 
     return 1;
-} /* TIFFParseInfo() */
-
+} /* TIFFParseIFD() */
 //
-// Read (and optionally bit flip) more VLC data for decoding
+// Read the file header and the first page
 //
-static void TIFFGetMoreData(TIFFIMAGE *pPage)
+static int TIFFParseInfo(TIFFIMAGE *pPage)
 {
-//    printf("Getting more data...\n");
-    // move any existing data down
-    if ((pPage->iVLCSize - pPage->iVLCOff) >= FILE_HIGHWATER)
-        return; // buffer is already full; no need to read more data
-    if (pPage->iVLCOff != 0)
+    int iBytesRead;
+    uint8_t *s = pPage->ucFileBuf;
+
+    iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, s, 16);
+    if (iBytesRead < 8)
     {
-        memcpy(&pPage->ucFileBuf[0], &pPage->ucFileBuf[pPage->iVLCOff], pPage->iVLCSize - pPage->iVLCOff);
-        pPage->iVLCSize -= pPage->iVLCOff;
-        pPage->iVLCOff = 0;
+        pPage->iError = TIFF_INVALID_FILE;
+        return 0;
     }
-    if (pPage->TIFFFile.iPos < pPage->TIFFFile.iSize && pPage->iVLCSize < FILE_HIGHWATER)
+    if (s[0] != s[1] || (s[0] != 'M' && s[0] != 'I'))
     {
-        int i, iBytesRead;
-        // Try to read enough to fill the buffer
-        iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, &pPage->ucFileBuf[pPage->iVLCSize], TIFF_FILE_BUF_SIZE - pPage->iVLCSize); // max length we can read
-        // flip bit direction if needed
-        if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
+        pPage->iError = TIFF_INVALID_FILE;
+        return 0; // not a TIFF file
+    }
+    pPage->ucMotorola = (s[0] == 'M');
+    pPage->ucBigTIFF = (TIFFSHORT(&s[2], pPage->ucMotorola) == 43);
+    if (pPage->ucBigTIFF) // 8-byte offsets
+    {
+        if (iBytesRead != 16 || TIFFSHORT(&s[4], pPage->ucMotorola) != 8)
+        {
+            pPage->iError = TIFF_INVALID_FILE;
+            return 0;
+        }
+        pPage->iFirstIFD = TIFFOffset(TIFFLONG64(&s[8], pPage->ucMotorola));
+    }
+    else
+    {
+        pPage->iFirstIFD = TIFFOffset(TIFFLONG(&s[4], pPage->ucMotorola)); // get IFD
+    }
+    pPage->iPage = 0;
+    return TIFFParseIFD(pPage, pPage->iFirstIFD);
+} /* TIFFParseInfo() */
+//
+// Get the offset of the IFD which follows the given one
+// returns 0 at the end of the chain or if it's corrupt
+//
+static TIFF_OFFSET TIFFNextIFD(TIFFIMAGE *pPage, TIFF_OFFSET IFD)
+{
+    uint8_t ucTemp[8];
+    int iCountSize, iTagCount;
+    TIFF_OFFSET iNext;
+
+    iCountSize = pPage->ucBigTIFF ? 8 : 2; // and the size of the next IFD offset is 8 or 4
+    if (IFD < 8 || IFD > pPage->TIFFFile.iSize - (iCountSize + 4))
+        return 0;
+    (*pPage->pfnSeek)(&pPage->TIFFFile, IFD);
+    if ((*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, iCountSize) != iCountSize)
+        return 0;
+    if (pPage->ucBigTIFF)
+        iTagCount = (TIFFLONG64(ucTemp, pPage->ucMotorola) > MAX_TIFF_TAGS) ? 0 : (int)TIFFLONG64(ucTemp, pPage->ucMotorola);
+    else
+        iTagCount = TIFFSHORT(ucTemp, pPage->ucMotorola);
+    if (iTagCount == 0 || iTagCount > MAX_TIFF_TAGS)
+        return 0;
+    (*pPage->pfnSeek)(&pPage->TIFFFile, IFD + iCountSize + iTagCount * (pPage->ucBigTIFF ? TIFF_BIGTAG_SIZE : TIFF_TAG_SIZE));
+    if (pPage->ucBigTIFF)
+    {
+        if ((*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, 8) != 8)
+            return 0;
+        iNext = TIFFOffset(TIFFLONG64(ucTemp, pPage->ucMotorola));
+    }
+    else
+    {
+        if ((*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, 4) != 4)
+            return 0;
+        iNext = TIFFOffset(TIFFLONG(ucTemp, pPage->ucMotorola));
+    }
+    if (iNext == IFD || iNext < 0) // a simple loop or too big
+        return 0;
+    return iNext;
+} /* TIFFNextIFD() */
+//
+// Count the pages by following the IFD chain
+// (desktop builds keep the IFD offsets so a page can be opened directly)
+//
+static int TIFFPageCount(TIFFIMAGE *pPage)
+{
+    TIFF_OFFSET IFD;
+    int iCount = 0;
+
+    if (pPage->iPageCount) // already counted
+        return pPage->iPageCount;
+    IFD = pPage->iFirstIFD;
+    while (IFD > 0 && iCount < TIFF_MAX_PAGES)
+    {
+#ifdef TIFF_ARENA
+        if ((iCount & 15) == 0) // make room for more
         {
-            for (i=0; i<iBytesRead; i++)
+            TIFF_OFFSET *pIFDs = (TIFF_OFFSET *)realloc(pPage->pPageIFD, (iCount + 16) * sizeof(TIFF_OFFSET));
+            if (pIFDs == NULL)
             {
-                uint8_t c = pPage->ucFileBuf[i+pPage->iVLCSize];
-                pPage->ucFileBuf[i+pPage->iVLCSize] = pgm_read_byte(&ucMirror[c]);
+                free(pPage->pPageIFD);
+                pPage->pPageIFD = NULL;
+                pPage->iError = TIFF_OUT_OF_MEMORY;
+                return 0;
             }
+            pPage->pPageIFD = pIFDs;
         }
+        pPage->pPageIFD[iCount] = IFD;
+#endif
+        iCount++;
+        IFD = TIFFNextIFD(pPage, IFD);
+    }
+    pPage->iPageCount = iCount;
+    return iCount;
+} /* TIFFPageCount() */
+//
+// Parse the IFD of the given page (starting at 0)
+// returns 1 for success, 0 for failure (and sets iError)
+//
+static int TIFFOpenPage(TIFFIMAGE *pPage, int iPage)
+{
+    TIFF_OFFSET IFD;
+#ifndef TIFF_ARENA
+    int i;
+#endif
+
+    pPage->iError = TIFF_SUCCESS;
+    if (iPage < 0 || iPage >= TIFFPageCount(pPage))
+    {
+        if (pPage->iError == TIFF_SUCCESS)
+            pPage->iError = TIFF_INVALID_PARAMETER;
+        return 0;
+    }
+#ifdef TIFF_ARENA
+    IFD = pPage->pPageIFD[iPage];
+#else
+    IFD = pPage->iFirstIFD;
+    for (i=0; i<iPage; i++) // no index, follow the chain
+        IFD = TIFFNextIFD(pPage, IFD);
+#endif
+    pPage->iPage = iPage;
+    return TIFFParseIFD(pPage, IFD);
+} /* TIFFOpenPage() */
+//
+// Reset the decoder state so that the page can be decoded again
+// The parsed header, callbacks, draw parameters and buffers are kept;
+// each strip is read from its start when it's decoded
+//
+static void TIFFRewind(TIFFIMAGE *pPage)
+{
+    pPage->iError = TIFF_SUCCESS;
+    pPage->y = 0;
+    pPage->u32Accum = 0;
+    pPage->ucRowState = 0;
+    pPage->iFlipCount = 0;
+    pPage->iDamagedRows = 0;
+    pPage->iVLCSize = pPage->iVLCOff = 0;
+} /* TIFFRewind() */
+
+//
+// Guard region written after the compressed data
+// In 2D mode, the zeros are the invalid mode code (or a run of 0 followed by it).
+// In uncompressed mode, the zeros end with a 1 which terminates uncompressed
+// mode (a 2nd one is needed if it started just before the first one) and the
+// zeros which follow it are again an invalid mode code.
+//
+static const uint8_t ucGuard[TIFF_GUARD_SIZE] PROGMEM = {
+    0,0,0,0,0x80,0,0,0,0,0x80,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+//
+// Set the end of the compressed data; bGuard = it's followed by the guard
+// region. Otherwise (the caller's memory) the refills of the last word go
+// through TIFFTailLoad()
+//
+static void TIFFSetDataEnd(TIFFIMAGE *pPage, uint8_t *pEnd, int bGuard)
+{
+    pPage->pDataEnd = pEnd;
+    pPage->pLoadEnd = pEnd - (sizeof(BIGUINT) - 1);
+    if (bGuard)
+        pPage->pLoadEnd += TIFF_GUARD_SIZE;
+} /* TIFFSetDataEnd() */
+#ifdef TIFF_ZERO_COPY
+//
+// Refill the bit reader from the end of the data; the bytes past the end
+// read as the guard region, so the decoder stops the same way it does in
+// ucFileBuf
+//
+static BIGUINT TIFFTailLoad(TIFFIMAGE *pPage, uint8_t *p)
+{
+    uint8_t uc[sizeof(BIGUINT)], *pEnd = pPage->pLoadEnd + (sizeof(BIGUINT) - 1);
+    intptr_t iOff;
+    int i;
+
+    for (i=0; i<(int)sizeof(BIGUINT); i++)
+    {
+        iOff = &p[i] - pEnd;
+        if (iOff < 0)
+            uc[i] = p[i];
+        else
+            uc[i] = (iOff < TIFF_GUARD_SIZE) ? pgm_read_byte(&ucGuard[iOff]) : 0;
+    }
+    return TIFFMOTOLONG(uc);
+} /* TIFFTailLoad() */
+#endif // TIFF_ZERO_COPY
+
+static void TIFFSetGuard(TIFFIMAGE *pPage)
+{
+    memcpy_P(&pPage->pVLC[pPage->iVLCSize], ucGuard, TIFF_GUARD_SIZE);
+    TIFFSetDataEnd(pPage, &pPage->pVLC[pPage->iVLCSize], 1);
+} /* TIFFSetGuard() */
+//
+// Reverse the bit order of each byte (FillOrder = 2)
+//
+static void TIFFMirror(uint8_t *pData, int iLen)
+{
+    int i;
+
+    for (i=0; i<iLen; i++)
+        pData[i] = pgm_read_byte(&ucMirror[pData[i]]);
+} /* TIFFMirror() */
+//
+// Read (and optionally bit flip) more VLC data for decoding
+//
+static void TIFFGetMoreData(TIFFIMAGE *pPage)
+{
+    uint8_t *pVLC = pPage->pVLC;
+    int iHighWater = (pPage->iVLCBufSize * 3) >> 2;
+
+//    printf("Getting more data...\n");
+    // move any existing data down
+    if ((pPage->iVLCSize - pPage->iVLCOff) >= iHighWater)
+        return; // buffer is already full; no need to read more data
+    if (pPage->iVLCOff > pPage->iVLCSize) // the decoder went into the guard region
+        pPage->iVLCOff = pPage->iVLCSize;
+    if (pPage->iVLCOff != 0)
+    {
+        memcpy(&pVLC[0], &pVLC[pPage->iVLCOff], pPage->iVLCSize - pPage->iVLCOff);
+        pPage->iVLCSize -= pPage->iVLCOff;
+        pPage->iVLCOff = 0;
+    }
+    if (pPage->TIFFFile.iPos < pPage->iReadEnd && pPage->iVLCSize < iHighWater)
+    {
+        int iBytesRead, iLen;
+        // Try to read enough to fill the buffer, but not past the strip
+        iLen = pPage->iVLCBufSize - pPage->iVLCSize; // max length we can read
+        if (pPage->iReadEnd - pPage->TIFFFile.iPos < iLen)
+            iLen = (int)(pPage->iReadEnd - pPage->TIFFFile.iPos);
+        iBytesRead = (*pPage->pfnRead)(&pPage->TIFFFile, &pVLC[pPage->iVLCSize], iLen);
+        // flip bit direction if needed
+        if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
+            TIFF_MIRROR(&pVLC[pPage->iVLCSize], iBytesRead);
         pPage->iVLCSize += iBytesRead;
     }
+    TIFFSetGuard(pPage);
 } /* TIFFGetMoreData() */
+//
+// Choose the buffer for the compressed data of the current strip and where its
+// reads stop. Strips which don't fit in ucFileBuf are read into the caller's
+// strip buffer, or one allocated to fit them (TIFF_ARENA). If there isn't one,
+// the strip is streamed through whichever buffer is larger.
+//
+static void TIFFSetStripBuffer(TIFFIMAGE *pPage)
+{
+    TIFF_OFFSET iSize = pPage->TIFFFile.iSize;
+    int iStripSize = pPage->iStripSize;
+
+    pPage->iReadEnd = iSize; // no StripByteCounts, read as far as the decoder goes
+    if (iStripSize > 0 && pPage->iStripOffset >= 0 && pPage->iStripOffset < iSize && iStripSize <= iSize - pPage->iStripOffset)
+        pPage->iReadEnd = pPage->iStripOffset + iStripSize;
+    else
+        iStripSize = 0;
+    pPage->pVLC = pPage->ucFileBuf;
+    pPage->iVLCBufSize = TIFF_FILE_BUF_SIZE;
+    if (iStripSize <= TIFF_FILE_BUF_SIZE)
+        return; // it fits in ucFileBuf (or its size isn't known)
+    if (pPage->pStripBuf && pPage->iStripBufSize - TIFF_GUARD_SIZE > TIFF_FILE_BUF_SIZE)
+    {
+        pPage->pVLC = pPage->pStripBuf;
+        pPage->iVLCBufSize = pPage->iStripBufSize - TIFF_GUARD_SIZE;
+        return;
+    }
+#ifdef TIFF_ARENA
+    if (iStripSize > TIFF_MAX_STRIP_BUF)
+        iStripSize = TIFF_MAX_STRIP_BUF;
+    if (iStripSize > pPage->iStripHeapSize) // first use or it grew
+    {
+        free(pPage->pStripHeap);
+        pPage->iStripHeapSize = 0;
+        pPage->pStripHeap = (uint8_t *)malloc(iStripSize + TIFF_GUARD_SIZE);
+        if (pPage->pStripHeap == NULL)
+            return; // stream it through ucFileBuf
+        pPage->iStripHeapSize = iStripSize;
+    }
+    pPage->pVLC = pPage->pStripHeap;
+    pPage->iVLCBufSize = pPage->iStripHeapSize;
+#endif // TIFF_ARENA
+} /* TIFFSetStripBuffer() */
+
+//
+// Convert the 2-bpp pixels into RGB565 using the 4 colors for the gray levels
+// Runs in reverse order to re-use the memory
+//
+static void TIFFGray2Color(uint8_t *pPixels, int iCount, const uint16_t *pColors)
+{
+    int x;
+    uint16_t *d16 = (uint16_t *)pPixels;
 
+    for (x=iCount-1; x>=0; x--)
+        d16[x] = pColors[(pPixels[x >> 2] >> (6 - ((x & 3)*2))) & 3];
+} /* TIFFGray2Color() */
 //
 // Width is the doubled pixel width
 // Convert 1-bpp into RGB565
 //
 static void Scale2Color(TIFFIMAGE *pPage, int width)
 {
-    int iPitch = pPage->iPitch;
-    int x, count;
-    uint8_t shift, ucPixels, c, d, *dest, *source;
-    uint16_t *d16, usPixel;
+    int i;
+    uint16_t usColors[4], usPixel;
     const uint32_t ulClrConvert0[4] = {0,5,11,16};
     const uint32_t ulClrConvert1[4] = {0,0,0,16}; // for scales >= 1.0
-    uint32_t *pConvert;
+    const uint32_t *pConvert;
     const uint32_t ulClrMask = 0x07e0f81f;
-    uint32_t ulPixel, ulAlpha, ulFG, ulBG;
+    uint32_t ulPixel, ulFG, ulBG;
     // Prepare the foreground and background colors for alpha calculations
     ulFG = pPage->usFG | ((uint32_t)pPage->usFG << 16);
     ulBG = pPage->usBG | ((uint32_t)pPage->usBG << 16);
     ulFG &= ulClrMask; ulBG &= ulClrMask;
 
-    pConvert = (pPage->window.iScale >= 65536) ? (uint32_t *)ulClrConvert1 : (uint32_t *)ulClrConvert0;
-    dest = source = pPage->ucPixels; // write the new pixels over the old to save memory
-// Convert everything to 2-bpp grayscale first
-    for (x=0; x<width/8; x+=2) /* Convert a pair of lines to gray */
-    {
-        c = source[x];  // first 4x2 block
-        d = source[x+iPitch];
-        /* two lines of 8 pixels are converted to one line of 4 pixels */
-        ucPixels = (pgm_read_byte(&ucGray2BPP[(unsigned char)((c & 0xf0) | (d >> 4))]) << 4);
-        ucPixels |= (pgm_read_byte(&ucGray2BPP[(unsigned char)((c << 4) | (d & 0x0f))]));
-        *dest++ = ucPixels;
-        c = source[x+1];  // next 4x2 block
-        d = source[x+iPitch+1];
-        ucPixels = (pgm_read_byte(&ucGray2BPP[(unsigned char)((c & 0xf0) | (d >> 4))]))<<4;
-        ucPixels |= pgm_read_byte(&ucGray2BPP[(unsigned char)((c << 4) | (d & 0x0f))]);
-        *dest++ = ucPixels;
-    }
-    if (width & 4) // 2 more pixels to do
-    {
-        c = source[x];
-        d = source[x + iPitch];
-        ucPixels = (pgm_read_byte(&ucGray2BPP[(unsigned char) ((c & 0xf0) | (d >> 4))])) << 4;
-        ucPixels |= (pgm_read_byte(&ucGray2BPP[(unsigned char) ((c << 4) | (d & 0x0f))]));
-        dest[0] = ucPixels;
-    }
-  // Now convert to the requested foreground/background colors
-  // Run in reverse order to re-use the memory
-    count = width >>1;
-    d16 = (uint16_t *)&pPage->ucPixels[0];
-    source = pPage->ucPixels; // byte pointer into 2-bpp pixels
-    ucPixels = source[(count+2)/4];
-    shift = 6-(((count-1) & 3)*2);
-    for (x=count-1; x>=0; x--) {
-       c = (ucPixels >> shift) & 3;
-       shift += 2; // go backwards through the bytes
-       if (shift == 8) {
-          shift = 0;
-          ucPixels = source[(x+3)/4];
-       }
-       // convert 2-bit value into a mixture of FG & BG colors
-       ulAlpha = pConvert[c]; // 0-3 scaled from 0 to 100% in thirds
-       ulPixel = ((ulBG * ulAlpha) + (ulFG * (16-ulAlpha))) >> 4;
+    pConvert = (pPage->window.iScale >= 65536) ? ulClrConvert1 : ulClrConvert0;
+    // convert each 2-bit value into a mixture of FG & BG colors
+    for (i=0; i<4; i++) {
+       ulPixel = ((ulBG * pConvert[i]) + (ulFG * (16-pConvert[i]))) >> 4; // 0-3 scaled from 0 to 100% in thirds
        ulPixel &= ulClrMask; // separate the RGBs
        usPixel = (uint16_t)ulPixel | (uint16_t)(ulPixel >> 16); // bring G back to RB
-       d16[x] = (uint16_t)((usPixel >> 8) | (usPixel << 8)); // final pixel
-    } // for x
+       usColors[i] = (uint16_t)((usPixel >> 8) | (usPixel << 8)); // final pixel
+    }
+    // Convert everything to 2-bpp grayscale first (written over the old pixels)
+    TIFF_SCALE2GRAY(pPage->ucPixels, width, pPage->iPitch);
+    // Now convert to the requested foreground/background colors
+    TIFF_GRAY2COLOR(pPage->ucPixels, width >> 1, usColors);
 } /* Scale2Color() */
 //
+// Number of bytes converted by Scale2Gray() and Scale2Gray4BPP()
+// (pairs of bytes + a final one if there are 2 more pixels)
+//
+#define GRAY_BYTES(width) ((((width)/8 + 1) & ~1) + (((width) & 4) ? 1 : 0))
+//
 // Width is the doubled pixel width
 // Convert 1-bpp into 2-bit grayscale
 //
@@ -835,140 +1695,741 @@ static void Scale2Gray4BPP(uint8_t *source, uint8_t *dest, int width, int iPitch
     }
 } /* Scale2Gray4BPP() */
 
-static int TIFFDrawLine(TIFFIMAGE *pPage, int y, int16_t *pCurFlips)
+#ifdef TIFF_SIMD
+//
+// SIMD versions of the per-line kernels
+// They produce exactly the same output as the C versions above
+//
+#define TIFF_TARGET(s) __attribute__((target(s)))
+
+static void TIFFZeroFill(uint8_t *pDest, int iLen)
 {
-    int x, len, run, sx, srun;
-    uint8_t lBit, rBit, *p;
-    int iStart = 0, xright = pPage->iWidth;
-    uint32_t u32ScaleFactor;
-    uint8_t *pDest;
-    TIFFDRAW obgd;
+    while (iLen > 0)
+    {
+        *pDest++ = 0;
+        iLen--;
+    }
+} /* TIFFZeroFill() */
+//
+// Scale2Gray() and Scale2Gray4BPP() for a single byte of each line
+// (the remaining bytes of the vector versions)
+//
+static inline uint8_t Gray2BPPByte(uint8_t c, uint8_t d)
+{
+    return (uint8_t)((pgm_read_byte(&ucGray2BPP[(uint8_t)((c & 0xf0) | (d >> 4))]) << 4) | pgm_read_byte(&ucGray2BPP[(uint8_t)((c << 4) | (d & 0x0f))]));
+} /* Gray2BPPByte() */
 
-    u32ScaleFactor = pPage->window.iScale;
-    obgd.iWidth = pPage->iWidth; // original image size
-    obgd.iHeight = pPage->iHeight;
-    obgd.iDestX = pPage->window.dstx;
-    obgd.iDestY = pPage->window.dsty;
-    obgd.iScaledWidth = (pPage->window.iWidth * u32ScaleFactor) >> 16;
-    obgd.iScaledHeight = (pPage->window.iHeight * u32ScaleFactor) >> 16;
-    obgd.pUser = pPage->pUser;
-    iStart = pPage->window.x;
-    
-    if (y >= pPage->window.y + pPage->window.iHeight)
-       return 0; // stop decoding
-    if (y == pPage->window.y) // start first line at white
+static inline void Gray4BPPBytes(uint8_t c, uint8_t d, uint8_t *dest)
+{
+    dest[0] = ucGray4BPP[(uint8_t)((c & 0xf0) | (d >> 4))];
+    dest[1] = ucGray4BPP[(uint8_t)((c << 4) | (d & 0x0f))];
+} /* Gray4BPPBytes() */
+//
+// SSE2 (always available on x86-64)
+//
+static void TIFFZeroFill_SSE2(uint8_t *pDest, int iLen)
+{
+    const __m128i z = _mm_setzero_si128();
+    int i;
+
+    if (iLen < 16) {
+        TIFFZeroFill(pDest, iLen);
+        return;
+    }
+    for (i=0; i<iLen-16; i+=16)
+        _mm_storeu_si128((__m128i *)&pDest[i], z);
+    _mm_storeu_si128((__m128i *)&pDest[iLen-16], z); // last (overlapping) 16
+} /* TIFFZeroFill_SSE2() */
+
+static void TIFFMirror_SSE2(uint8_t *pData, int iLen)
+{
+    const __m128i m0f = _mm_set1_epi8(0x0f), m33 = _mm_set1_epi8(0x33), m55 = _mm_set1_epi8(0x55);
+    __m128i v;
+    int i;
+
+    for (i=0; i+16<=iLen; i+=16)
     {
-        pPage->u32Accum = 0;
-        pPage->y = 0; // old Y value
-        pPage->iPitch = (pPage->iWidth+7)>>3;
-        if (u32ScaleFactor != 0x10000)
-            pPage->iPitch = (((pPage->iWidth * u32ScaleFactor) >> 16) + 7) >> 3;
-        if (pPage->window.ucPixelType >= TIFF_PIXEL_2BPP)
-        {
-            pPage->iPitch *= 2; // scale-to-gray is 4x as much memory
-            if (pPage->iPitch*2 < MAX_BUFFERED_PIXELS)
-                memset(pPage->ucPixels, 0xff, pPage->iPitch*2); // start as 0xff (white)
-        }
-        else
-        {
-            if (pPage->iPitch < MAX_BUFFERED_PIXELS)
-                memset(pPage->ucPixels, 0xff, pPage->iPitch); // start as 0xff (white)
-        }
+        v = _mm_loadu_si128((__m128i *)&pData[i]);
+        // swap the nibbles, then the bit pairs, then the bits
+        v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 4), m0f), _mm_slli_epi16(_mm_and_si128(v, m0f), 4));
+        v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 2), m33), _mm_slli_epi16(_mm_and_si128(v, m33), 2));
+        v = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 1), m55), _mm_slli_epi16(_mm_and_si128(v, m55), 1));
+        _mm_storeu_si128((__m128i *)&pData[i], v);
     }
-    pDest = pPage->ucPixels;
-    if (pPage->window.ucPixelType >= TIFF_PIXEL_2BPP)
-       {
-           u32ScaleFactor <<= 1; // double the scale
-           if ((pPage->u32Accum >> 16) >= 1) // second line
-               pDest = &pPage->ucPixels[pPage->iPitch];
-       }
-    pPage->u32Accum += u32ScaleFactor;
-    if ((y < pPage->window.y) || (y & 1 && u32ScaleFactor < 0x4000))
-        return 1; // no need to draw anything, if shrinking too tiny, skip every line
-       x = 0;
-       while (x < xright) // while the scaled x is within the window bounds
-        {
-            x = *pCurFlips++; // black starting point
-            run = *pCurFlips++ - x; // get the black run
-            if (run < 0) {
-                return 0; // an error occurred - the run should never be negative in length
-            }
-            x -= iStart;
-          if (x >= xright || run == 0)
-             break;
-            if ((x + run) > 0) { /* If the run is visible, draw it */
-                if (x < 0) {
-                    run += x; /* draw only visible part of run */
-                    x = 0;
-                }
-          /* Scale the starting x and run down to size */
-                if ((x + run) > xright) { /* Don't let it go off right edge */
-                    run = xright - x;
-                }
-             sx = (x * u32ScaleFactor)>>16;
-             srun = (run * u32ScaleFactor)>>16;
-             if (srun < 1) /* Always draw at least one pixel */
-                srun = 1;
-             /* Draw this run */
-             lBit = 0xff << (8 - (sx & 7));
-             rBit = 0xff >> ((sx + srun) & 7);
-             len = ((sx+srun)>>3) - (sx >> 3);
-             p = &pDest[sx >> 3];
-             if (len == 0)
-                {
-                lBit |= rBit;
-                *p &= lBit;
-                }
-             else
-                {
-                *p++ &= lBit;
-                while (len > 1)
-                   {
-                   *p++ = 0;
-                   len--;
-                   }
-                *p = rBit;
-                }
-             }
-          } /* while drawing line */
-    obgd.ucLast = 0;
-    if (y == pPage->iHeight-1 && obgd.ucPixelType >= TIFF_PIXEL_2BPP) // antialiased image at the last line, force a final draw
+    TIFFMirror(&pData[i], iLen - i);
+} /* TIFFMirror_SSE2() */
+//
+// Count the white pixels in each 2x2 block of 16 bytes of the 2 lines
+// pOdd gets the counts of pixels 0-1 (upper nibble) and 4-5 (lower nibble)
+// pEven gets the counts of pixels 2-3 (upper nibble) and 6-7 (lower nibble)
+//
+static inline void GrayCounts_SSE2(__m128i c, __m128i d, __m128i *pOdd, __m128i *pEven)
+{
+    const __m128i m33 = _mm_set1_epi8(0x33), m55 = _mm_set1_epi8(0x55);
+
+    c = _mm_add_epi8(_mm_and_si128(c, m55), _mm_and_si128(_mm_srli_epi16(c, 1), m55)); // pairs
+    d = _mm_add_epi8(_mm_and_si128(d, m55), _mm_and_si128(_mm_srli_epi16(d, 1), m55));
+    *pOdd = _mm_add_epi8(_mm_and_si128(_mm_srli_epi16(c, 2), m33), _mm_and_si128(_mm_srli_epi16(d, 2), m33));
+    *pEven = _mm_add_epi8(_mm_and_si128(c, m33), _mm_and_si128(d, m33));
+} /* GrayCounts_SSE2() */
+
+static void Scale2Gray_SSE2(uint8_t *source, int width, int iPitch)
+{
+    const __m128i m11 = _mm_set1_epi8(0x11), m55 = _mm_set1_epi8(0x55);
+    __m128i o, e;
+    int x, iCount = GRAY_BYTES(width);
+
+    for (x=0; x+16<=iCount; x+=16)
     {
-        pPage->u32Accum = 0x20000;
-        obgd.ucLast = 1;
+        GrayCounts_SSE2(_mm_loadu_si128((__m128i *)&source[x]), _mm_loadu_si128((__m128i *)&source[x+iPitch]), &o, &e);
+        // 0,1,2,3,4 white pixels -> gray level 0,1,2,2,3 (subtract 1 if count+5 has bit 3 set)
+        o = _mm_sub_epi8(o, _mm_and_si128(_mm_srli_epi16(_mm_add_epi8(o, m55), 3), m11));
+        e = _mm_sub_epi8(e, _mm_and_si128(_mm_srli_epi16(_mm_add_epi8(e, m55), 3), m11));
+        _mm_storeu_si128((__m128i *)&source[x], _mm_or_si128(_mm_slli_epi16(o, 2), e));
     }
-    obgd.ucPixelType = pPage->window.ucPixelType;
-    if (obgd.ucPixelType >= TIFF_PIXEL_2BPP)
+    for (; x<iCount; x++)
+        source[x] = Gray2BPPByte(source[x], source[x+iPitch]);
+} /* Scale2Gray_SSE2() */
+//
+// 0,1,2,3,4 white pixels -> 4-bpp gray level 0,4,8,7,15 (the ucGray4BPP values)
+//
+static inline __m128i Gray4Level_SSE2(__m128i n)
+{
+    __m128i g;
+
+    g = _mm_add_epi8(n, n);
+    g = _mm_add_epi8(g, g);
+    g = _mm_add_epi8(g, _mm_and_si128(_mm_cmpeq_epi8(n, _mm_set1_epi8(3)), _mm_set1_epi8(-5)));
+    return _mm_add_epi8(g, _mm_cmpeq_epi8(n, _mm_set1_epi8(4))); // -1
+} /* Gray4Level_SSE2() */
+
+static void Scale2Gray4BPP_SSE2(uint8_t *source, uint8_t *dest, int width, int iPitch)
+{
+    const __m128i m0f = _mm_set1_epi8(0x0f);
+    __m128i o, e, b0, b1;
+    int x, iCount = GRAY_BYTES(width);
+
+    for (x=0; x+16<=iCount; x+=16)
     {
-        if ((pPage->u32Accum >> 16) >= 2)
-        {
-            // Time to output the two lines as scale-to-gray
-            // Convert the stretched pixels to 2-bit grayscale
-            if (obgd.ucPixelType == TIFF_PIXEL_2BPP)
-            {
-                obgd.pPixels = pPage->ucPixels;
-                Scale2Gray(pPage->ucPixels, obgd.iScaledWidth*2, pPage->iPitch);
-            }
-            else if (obgd.ucPixelType == TIFF_PIXEL_4BPP)
-            {
-                obgd.pPixels = pPage->window.p4BPP; // need a larger buffer for 4-bit pixels
-                Scale2Gray4BPP(pPage->ucPixels, pPage->window.p4BPP, obgd.iScaledWidth*2, pPage->iPitch);
-            }
-            else // Convert to RGB565 color output
-            {
-               Scale2Color(pPage, obgd.iScaledWidth*2); 
-               obgd.pPixels = pPage->ucPixels;
-            }
-            // When stretching the image, we may need to repeat lines
-            while (pPage->u32Accum >= 0x20000)
+        GrayCounts_SSE2(_mm_loadu_si128((__m128i *)&source[x]), _mm_loadu_si128((__m128i *)&source[x+iPitch]), &o, &e);
+        b0 = _mm_or_si128(_mm_slli_epi16(Gray4Level_SSE2(_mm_and_si128(_mm_srli_epi16(o, 4), m0f)), 4), Gray4Level_SSE2(_mm_and_si128(_mm_srli_epi16(e, 4), m0f)));
+        b1 = _mm_or_si128(_mm_slli_epi16(Gray4Level_SSE2(_mm_and_si128(o, m0f)), 4), Gray4Level_SSE2(_mm_and_si128(e, m0f)));
+        _mm_storeu_si128((__m128i *)&dest[x*2], _mm_unpacklo_epi8(b0, b1));
+        _mm_storeu_si128((__m128i *)&dest[x*2+16], _mm_unpackhi_epi8(b0, b1));
+    }
+    for (; x<iCount; x++)
+        Gray4BPPBytes(source[x], source[x+iPitch], &dest[x*2]);
+} /* Scale2Gray4BPP_SSE2() */
+//
+// SSSE3 (PSHUFB table lookups)
+//
+TIFF_TARGET("ssse3")
+static void TIFFMirror_SSSE3(uint8_t *pData, int iLen)
+{
+    const __m128i m0f = _mm_set1_epi8(0x0f);
+    const __m128i mRev = _mm_setr_epi8(0x00,0x08,0x04,0x0c,0x02,0x0a,0x06,0x0e,0x01,0x09,0x05,0x0d,0x03,0x0b,0x07,0x0f);
+    const __m128i mRevHi = _mm_slli_epi16(mRev, 4);
+    __m128i v;
+    int i;
+
+    for (i=0; i+16<=iLen; i+=16)
+    {
+        v = _mm_loadu_si128((__m128i *)&pData[i]);
+        v = _mm_or_si128(_mm_shuffle_epi8(mRevHi, _mm_and_si128(v, m0f)), _mm_shuffle_epi8(mRev, _mm_and_si128(_mm_srli_epi16(v, 4), m0f)));
+        _mm_storeu_si128((__m128i *)&pData[i], v);
+    }
+    TIFFMirror(&pData[i], iLen - i);
+} /* TIFFMirror_SSSE3() */
+
+TIFF_TARGET("ssse3")
+static void Scale2Gray4BPP_SSSE3(uint8_t *source, uint8_t *dest, int width, int iPitch)
+{
+    const __m128i m0f = _mm_set1_epi8(0x0f);
+    const __m128i mLevel = _mm_setr_epi8(0,4,8,7,15,0,0,0,0,0,0,0,0,0,0,0);
+    const __m128i mLevelHi = _mm_slli_epi16(mLevel, 4);
+    __m128i o, e, b0, b1;
+    int x, iCount = GRAY_BYTES(width);
+
+    for (x=0; x+16<=iCount; x+=16)
+    {
+        GrayCounts_SSE2(_mm_loadu_si128((__m128i *)&source[x]), _mm_loadu_si128((__m128i *)&source[x+iPitch]), &o, &e);
+        b0 = _mm_or_si128(_mm_shuffle_epi8(mLevelHi, _mm_and_si128(_mm_srli_epi16(o, 4), m0f)), _mm_shuffle_epi8(mLevel, _mm_and_si128(_mm_srli_epi16(e, 4), m0f)));
+        b1 = _mm_or_si128(_mm_shuffle_epi8(mLevelHi, _mm_and_si128(o, m0f)), _mm_shuffle_epi8(mLevel, _mm_and_si128(e, m0f)));
+        _mm_storeu_si128((__m128i *)&dest[x*2], _mm_unpacklo_epi8(b0, b1));
+        _mm_storeu_si128((__m128i *)&dest[x*2+16], _mm_unpackhi_epi8(b0, b1));
+    }
+    for (; x<iCount; x++)
+        Gray4BPPBytes(source[x], source[x+iPitch], &dest[x*2]);
+} /* Scale2Gray4BPP_SSSE3() */
+//
+// 8 pixels (2 bytes of 2-bpp) at a time, from the end like the C version
+//
+TIFF_TARGET("ssse3")
+static void TIFFGray2Color_SSSE3(uint8_t *pPixels, int iCount, const uint16_t *pColors)
+{
+    const __m128i mSpread = _mm_setr_epi8(0,-1,0,-1,0,-1,0,-1,1,-1,1,-1,1,-1,1,-1); // byte x/4 to each 16-bit pixel
+    const __m128i mShift = _mm_setr_epi16(1,4,16,64,1,4,16,64); // move the 2-bit value to the top of the byte
+    const __m128i m03 = _mm_set1_epi16(3), mIndex = _mm_set1_epi16(0x0202), mHigh = _mm_set1_epi16(0x0100);
+    __m128i mColors, v;
+    uint16_t *d16 = (uint16_t *)pPixels;
+    int x, iChunks = iCount >> 3;
+
+    mColors = _mm_loadl_epi64((const __m128i *)pColors); // 4 RGB565 pixels
+    for (x=iCount-1; x>=iChunks*8; x--) // odd pixels at the end go first
+        d16[x] = pColors[(pPixels[x >> 2] >> (6 - ((x & 3)*2))) & 3];
+    for (x=iChunks-1; x>=0; x--)
+    {
+        v = _mm_cvtsi32_si128(pPixels[x*2] | (pPixels[x*2+1] << 8));
+        v = _mm_shuffle_epi8(v, mSpread);
+        v = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(v, mShift), 6), m03); // 0-3
+        v = _mm_add_epi16(_mm_mullo_epi16(v, mIndex), mHigh); // byte offsets of the color
+        _mm_storeu_si128((__m128i *)&pPixels[x*16], _mm_shuffle_epi8(mColors, v));
+    }
+} /* TIFFGray2Color_SSSE3() */
+//
+// AVX2 (32 bytes at a time)
+//
+TIFF_TARGET("avx2")
+static void TIFFZeroFill_AVX2(uint8_t *pDest, int iLen)
+{
+    const __m256i z = _mm256_setzero_si256();
+    int i;
+
+    if (iLen < 32) {
+        TIFFZeroFill_SSE2(pDest, iLen);
+        return;
+    }
+    for (i=0; i<iLen-32; i+=32)
+        _mm256_storeu_si256((__m256i *)&pDest[i], z);
+    _mm256_storeu_si256((__m256i *)&pDest[iLen-32], z); // last (overlapping) 32
+} /* TIFFZeroFill_AVX2() */
+
+TIFF_TARGET("avx2")
+static void TIFFMirror_AVX2(uint8_t *pData, int iLen)
+{
+    const __m256i m0f = _mm256_set1_epi8(0x0f);
+    const __m256i mRev = _mm256_setr_epi8(0x00,0x08,0x04,0x0c,0x02,0x0a,0x06,0x0e,0x01,0x09,0x05,0x0d,0x03,0x0b,0x07,0x0f,
+                                          0x00,0x08,0x04,0x0c,0x02,0x0a,0x06,0x0e,0x01,0x09,0x05,0x0d,0x03,0x0b,0x07,0x0f);
+    const __m256i mRevHi = _mm256_slli_epi16(mRev, 4);
+    __m256i v;
+    int i;
+
+    for (i=0; i+32<=iLen; i+=32)
+    {
+        v = _mm256_loadu_si256((__m256i *)&pData[i]);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(mRevHi, _mm256_and_si256(v, m0f)), _mm256_shuffle_epi8(mRev, _mm256_and_si256(_mm256_srli_epi16(v, 4), m0f)));
+        _mm256_storeu_si256((__m256i *)&pData[i], v);
+    }
+    TIFFMirror(&pData[i], iLen - i);
+} /* TIFFMirror_AVX2() */
+
+TIFF_TARGET("avx2")
+static inline void GrayCounts_AVX2(__m256i c, __m256i d, __m256i *pOdd, __m256i *pEven)
+{
+    const __m256i m33 = _mm256_set1_epi8(0x33), m55 = _mm256_set1_epi8(0x55);
+
+    c = _mm256_add_epi8(_mm256_and_si256(c, m55), _mm256_and_si256(_mm256_srli_epi16(c, 1), m55));
+    d = _mm256_add_epi8(_mm256_and_si256(d, m55), _mm256_and_si256(_mm256_srli_epi16(d, 1), m55));
+    *pOdd = _mm256_add_epi8(_mm256_and_si256(_mm256_srli_epi16(c, 2), m33), _mm256_and_si256(_mm256_srli_epi16(d, 2), m33));
+    *pEven = _mm256_add_epi8(_mm256_and_si256(c, m33), _mm256_and_si256(d, m33));
+} /* GrayCounts_AVX2() */
+
+TIFF_TARGET("avx2")
+static void Scale2Gray_AVX2(uint8_t *source, int width, int iPitch)
+{
+    const __m256i m11 = _mm256_set1_epi8(0x11), m55 = _mm256_set1_epi8(0x55);
+    __m256i o, e;
+    int x, iCount = GRAY_BYTES(width);
+
+    for (x=0; x+32<=iCount; x+=32)
+    {
+        GrayCounts_AVX2(_mm256_loadu_si256((__m256i *)&source[x]), _mm256_loadu_si256((__m256i *)&source[x+iPitch]), &o, &e);
+        o = _mm256_sub_epi8(o, _mm256_and_si256(_mm256_srli_epi16(_mm256_add_epi8(o, m55), 3), m11));
+        e = _mm256_sub_epi8(e, _mm256_and_si256(_mm256_srli_epi16(_mm256_add_epi8(e, m55), 3), m11));
+        _mm256_storeu_si256((__m256i *)&source[x], _mm256_or_si256(_mm256_slli_epi16(o, 2), e));
+    }
+    for (; x<iCount; x++)
+        source[x] = Gray2BPPByte(source[x], source[x+iPitch]);
+} /* Scale2Gray_AVX2() */
+
+TIFF_TARGET("avx2")
+static void Scale2Gray4BPP_AVX2(uint8_t *source, uint8_t *dest, int width, int iPitch)
+{
+    const __m256i m0f = _mm256_set1_epi8(0x0f);
+    const __m256i mLevel = _mm256_setr_epi8(0,4,8,7,15,0,0,0,0,0,0,0,0,0,0,0,0,4,8,7,15,0,0,0,0,0,0,0,0,0,0,0);
+    const __m256i mLevelHi = _mm256_slli_epi16(mLevel, 4);
+    __m256i o, e, b0, b1, lo, hi;
+    int x, iCount = GRAY_BYTES(width);
+
+    for (x=0; x+32<=iCount; x+=32)
+    {
+        GrayCounts_AVX2(_mm256_loadu_si256((__m256i *)&source[x]), _mm256_loadu_si256((__m256i *)&source[x+iPitch]), &o, &e);
+        b0 = _mm256_or_si256(_mm256_shuffle_epi8(mLevelHi, _mm256_and_si256(_mm256_srli_epi16(o, 4), m0f)), _mm256_shuffle_epi8(mLevel, _mm256_and_si256(_mm256_srli_epi16(e, 4), m0f)));
+        b1 = _mm256_or_si256(_mm256_shuffle_epi8(mLevelHi, _mm256_and_si256(o, m0f)), _mm256_shuffle_epi8(mLevel, _mm256_and_si256(e, m0f)));
+        lo = _mm256_unpacklo_epi8(b0, b1); // interleaves within each 128-bit lane
+        hi = _mm256_unpackhi_epi8(b0, b1);
+        _mm256_storeu_si256((__m256i *)&dest[x*2], _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)&dest[x*2+32], _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    for (; x<iCount; x++)
+        Gray4BPPBytes(source[x], source[x+iPitch], &dest[x*2]);
+} /* Scale2Gray4BPP_AVX2() */
+
+#ifdef TIFF_SIMD_VERIFY
+//
+// Run the C version of each kernel on a copy of the data and compare
+//
+static TIFFKERNELS TIFFVector; // the selected vector kernels
+
+static void TIFFVerify(const uint8_t *pC, const uint8_t *pVector, int iLen, const char *szKernel)
+{
+    if (iLen > 0 && memcmp(pC, pVector, iLen) != 0) {
+        fprintf(stderr, "TIFF_SIMD_VERIFY: %s differs from the C version\n", szKernel);
+        abort();
+    }
+} /* TIFFVerify() */
+
+static void TIFFMirror_Verify(uint8_t *pData, int iLen)
+{
+    uint8_t *pCopy;
+
+    if (iLen <= 0) return;
+    pCopy = (uint8_t *)malloc(iLen);
+    memcpy(pCopy, pData, iLen);
+    TIFFMirror(pCopy, iLen);
+    (*TIFFVector.pfnMirror)(pData, iLen);
+    TIFFVerify(pCopy, pData, iLen, "TIFFMirror");
+    free(pCopy);
+} /* TIFFMirror_Verify() */
+
+static void TIFFZeroFill_Verify(uint8_t *pDest, int iLen)
+{
+    uint8_t *pCopy;
+
+    if (iLen <= 0) return;
+    pCopy = (uint8_t *)malloc(iLen);
+    memcpy(pCopy, pDest, iLen);
+    TIFFZeroFill(pCopy, iLen);
+    (*TIFFVector.pfnZeroFill)(pDest, iLen);
+    TIFFVerify(pCopy, pDest, iLen, "TIFFZeroFill");
+    free(pCopy);
+} /* TIFFZeroFill_Verify() */
+
+static void Scale2Gray_Verify(uint8_t *source, int width, int iPitch)
+{
+    int iLen = iPitch + GRAY_BYTES(width); // both lines
+    uint8_t *pCopy = (uint8_t *)malloc(iLen);
+
+    memcpy(pCopy, source, iLen);
+    Scale2Gray(pCopy, width, iPitch);
+    (*TIFFVector.pfnScale2Gray)(source, width, iPitch);
+    TIFFVerify(pCopy, source, iLen, "Scale2Gray");
+    free(pCopy);
+} /* Scale2Gray_Verify() */
+
+static void Scale2Gray4BPP_Verify(uint8_t *source, uint8_t *dest, int width, int iPitch)
+{
+    int iLen = GRAY_BYTES(width) * 2;
+    uint8_t *pCopy = (uint8_t *)malloc(iLen);
+
+    Scale2Gray4BPP(source, pCopy, width, iPitch);
+    (*TIFFVector.pfnScale2Gray4BPP)(source, dest, width, iPitch);
+    TIFFVerify(pCopy, dest, iLen, "Scale2Gray4BPP");
+    free(pCopy);
+} /* Scale2Gray4BPP_Verify() */
+
+static void TIFFGray2Color_Verify(uint8_t *pPixels, int iCount, const uint16_t *pColors)
+{
+    int iLen = iCount * 2;
+    uint8_t *pCopy;
+
+    if (iLen <= 0) return;
+    pCopy = (uint8_t *)malloc(iLen);
+    memcpy(pCopy, pPixels, iLen);
+    TIFFGray2Color(pCopy, iCount, pColors);
+    (*TIFFVector.pfnGray2Color)(pPixels, iCount, pColors);
+    TIFFVerify(pCopy, pPixels, iLen, "TIFFGray2Color");
+    free(pCopy);
+} /* TIFFGray2Color_Verify() */
+#endif // TIFF_SIMD_VERIFY
+//
+// Select the kernels for this CPU (runs before main())
+//
+__attribute__((constructor))
+static void TIFFInitKernels(void)
+{
+    TIFFKERNELS *pK;
+
+#ifdef TIFF_SIMD_VERIFY
+    pK = &TIFFVector;
+#else
+    pK = &TIFFKernels;
+#endif
+    pK->pfnMirror = TIFFMirror; // the C code is the fallback
+    pK->pfnZeroFill = TIFFZeroFill;
+    pK->pfnScale2Gray = Scale2Gray;
+    pK->pfnScale2Gray4BPP = Scale2Gray4BPP;
+    pK->pfnGray2Color = TIFFGray2Color;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        pK->pfnMirror = TIFFMirror_SSE2;
+        pK->pfnZeroFill = TIFFZeroFill_SSE2;
+        pK->pfnScale2Gray = Scale2Gray_SSE2;
+        pK->pfnScale2Gray4BPP = Scale2Gray4BPP_SSE2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        pK->pfnMirror = TIFFMirror_SSSE3;
+        pK->pfnScale2Gray4BPP = Scale2Gray4BPP_SSSE3;
+        pK->pfnGray2Color = TIFFGray2Color_SSSE3;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        pK->pfnMirror = TIFFMirror_AVX2;
+        pK->pfnZeroFill = TIFFZeroFill_AVX2;
+        pK->pfnScale2Gray = Scale2Gray_AVX2;
+        pK->pfnScale2Gray4BPP = Scale2Gray4BPP_AVX2;
+    }
+#ifdef TIFF_SIMD_VERIFY
+    TIFFKernels.pfnMirror = TIFFMirror_Verify;
+    TIFFKernels.pfnZeroFill = TIFFZeroFill_Verify;
+    TIFFKernels.pfnScale2Gray = Scale2Gray_Verify;
+    TIFFKernels.pfnScale2Gray4BPP = Scale2Gray4BPP_Verify;
+    TIFFKernels.pfnGray2Color = TIFFGray2Color_Verify;
+#endif
+} /* TIFFInitKernels() */
+#endif // TIFF_SIMD
+
+//
+// Scale a width or x coordinate by a 16.16 fixed point factor
+// The product doesn't fit in 32-bits for wide images at large scales
+//
+static TIFF_ALWAYS_INLINE int TIFFScale(int iValue, uint32_t u32Scale)
+{
+    return (int)(((int64_t)iValue * u32Scale) >> 16);
+} /* TIFFScale() */
+
+#ifdef TIFF_ARENA
+#define PIXEL_BUF_SIZE(pPage) (pPage)->iPixelSize
+//
+// Calculate the arena size needed to decode the current image
+// with the current draw parameters
+// returns 0 if the scaled line is too wide to draw
+//
+static int TIFFBufferSize(TIFFIMAGE *pPage)
+{
+    int iWidth, iPitch, iPixels;
+    uint32_t u32ScaleFactor = pPage->window.iScale;
+
+    iWidth = pPage->iWidth;
+    if (pPage->window.iWidth > iWidth) // the scale-to-gray output is sized by the window
+        iWidth = pPage->window.iWidth;
+    // a scale or scaled line too large to draw
+    if (u32ScaleFactor > TIFF_MAX_SCALE || (int64_t)iWidth * u32ScaleFactor > ((int64_t)TIFF_MAX_SCALED_WIDTH << 16))
+        return 0;
+    // same as the pitch calculation in TIFFDrawLine()
+    iPitch = (iWidth+7)>>3;
+    if (u32ScaleFactor != 0x10000)
+        iPitch = (TIFFScale(iWidth, u32ScaleFactor) + 7) >> 3;
+    iPixels = iPitch;
+    if (pPage->window.ucPixelType >= TIFF_PIXEL_2BPP)
+        iPixels = iPitch * 4; // 2 lines at twice the scale
+    if (pPage->window.ucPixelType == TIFF_PIXEL_16BPP && iPitch * 16 > iPixels)
+        iPixels = iPitch * 16; // RGB565 output is written over the 2 lines
+    iPixels += 8; // the right edge of a run can touch the byte past the end of the line
+    return (TIFF_FLIPS_PER_LINE(pPage->iWidth) * 2 * (int)sizeof(TIFF_FLIP)) + iPixels;
+} /* TIFFBufferSize() */
+
+static void TIFFFreeBuffers(TIFFIMAGE *pPage)
+{
+    free(pPage->pPageIFD);
+    pPage->pPageIFD = NULL;
+    pPage->iPageCount = 0;
+    free(pPage->pHeap);
+    pPage->pHeap = NULL;
+    pPage->iHeapSize = 0;
+    free(pPage->pStripHeap);
+    pPage->pStripHeap = NULL;
+    pPage->iStripHeapSize = 0;
+    pPage->pArena = NULL;
+    pPage->iArenaSize = 0;
+} /* TIFFFreeBuffers() */
+#else
+#define PIXEL_BUF_SIZE(pPage) MAX_BUFFERED_PIXELS
+#endif // TIFF_ARENA
+//
+// Set up the flips and output line buffers for the current image
+// returns 1 for success, 0 for failure (and sets iError)
+//
+static int TIFFAllocBuffers(TIFFIMAGE *pPage)
+{
+#ifdef TIFF_ARENA
+    int iSize, iFlips;
+    uint8_t *pArena;
+#endif
+
+    // openRAW() and decodeIncBegin() don't check the size
+    if (pPage->iWidth <= 0 || pPage->iHeight <= 0) {
+        pPage->iError = TIFF_INVALID_PARAMETER;
+        return 0;
+    }
+    if (pPage->iWidth > TIFF_MAX_WIDTH) {
+        pPage->iError = TIFF_TOO_WIDE;
+        return 0;
+    }
+#ifdef TIFF_ARENA
+    iSize = TIFFBufferSize(pPage);
+    if (iSize == 0) {
+        pPage->iError = TIFF_TOO_WIDE;
+        return 0;
+    }
+    if (pPage->pArena) { // caller-supplied memory
+        if (iSize > pPage->iArenaSize) {
+            pPage->iError = TIFF_OUT_OF_MEMORY;
+            return 0;
+        }
+        pArena = pPage->pArena;
+    } else {
+        if (iSize > pPage->iHeapSize) { // first use or it grew
+            free(pPage->pHeap);
+            pPage->iHeapSize = 0;
+            pPage->pHeap = (uint8_t *)malloc(iSize);
+            if (pPage->pHeap == NULL) {
+                pPage->iError = TIFF_OUT_OF_MEMORY;
+                return 0;
+            }
+            pPage->iHeapSize = iSize;
+        }
+        pArena = pPage->pHeap;
+    }
+    iFlips = TIFF_FLIPS_PER_LINE(pPage->iWidth);
+    pPage->CurFlips = (TIFF_FLIP *)pArena;
+    pPage->RefFlips = &pPage->CurFlips[iFlips];
+    pPage->ucPixels = (uint8_t *)&pPage->RefFlips[iFlips];
+    pPage->iPixelSize = iSize - (iFlips * 2 * (int)sizeof(TIFF_FLIP));
+#endif // TIFF_ARENA
+    return 1;
+} /* TIFFAllocBuffers() */
+
+//
+// Draw a line of flips into the output buffer and pass it to the draw callback
+// when it's complete. The pixel type, scale and whether the window is clipped
+// are passed separately so that the C++ specialized decoders (see TIFF_G4.cpp)
+// can give them constant values and let the compiler remove the other cases.
+// Without clipping, the window must be the whole image.
+//
+static TIFF_ALWAYS_INLINE int TIFFDrawLineCore(TIFFIMAGE *pPage, int y, TIFF_FLIP *pCurFlips, uint8_t ucPixelType, uint32_t u32ScaleFactor, uint32_t u32ScaleY, int bClipped)
+{
+    int x, len, run, sx, srun, iNext, bInvert;
+    uint8_t lBit, rBit, *p, ucLineType;
+    int iStart = 0, xright = pPage->iWidth;
+    uint8_t *pDest;
+    TIFFDRAW obgd;
+
+    obgd.iWidth = pPage->iWidth; // original image size
+    obgd.iHeight = pPage->iHeight;
+    obgd.iDestX = pPage->window.dstx;
+    obgd.iDestY = pPage->window.dsty;
+    obgd.iScaledWidth = TIFFScale(pPage->window.iWidth, u32ScaleFactor);
+    obgd.iScaledHeight = TIFFScale(pPage->window.iHeight, u32ScaleY);
+    obgd.pUser = pPage->pUser;
+    obgd.iPage = pPage->iPage;
+    if (bClipped)
+        iStart = pPage->window.x;
+    // BlackIsZero images draw the coded white runs as the black ones
+    bInvert = (pPage->ucPhotometric == TIFF_PHOTOMETRIC_BLACKISZERO);
+    
+    if (bClipped && y >= pPage->window.y + pPage->window.iHeight)
+       return 0; // stop decoding
+    if (y == (bClipped ? pPage->window.y : 0)) // start first line at white
+    {
+        pPage->u32Accum = 0;
+        pPage->y = 0; // old Y value
+        pPage->iPitch = (pPage->iWidth+7)>>3;
+        if (u32ScaleFactor != 0x10000)
+            pPage->iPitch = (TIFFScale(pPage->iWidth, u32ScaleFactor) + 7) >> 3;
+        if (ucPixelType >= TIFF_PIXEL_2BPP)
+        {
+            pPage->iPitch *= 2; // scale-to-gray is 4x as much memory
+            if (pPage->iPitch*2 <= PIXEL_BUF_SIZE(pPage))
+                memset(pPage->ucPixels, 0xff, pPage->iPitch*2); // start as 0xff (white)
+        }
+        else
+        {
+            if (pPage->iPitch <= PIXEL_BUF_SIZE(pPage))
+                memset(pPage->ucPixels, 0xff, pPage->iPitch); // start as 0xff (white)
+        }
+        pPage->ucRowState = TIFF_ROW_WHITE;
+    }
+    pDest = pPage->ucPixels;
+    if (ucPixelType >= TIFF_PIXEL_2BPP)
+       {
+           u32ScaleFactor <<= 1; // double the scale
+           u32ScaleY <<= 1;
+           if ((pPage->u32Accum >> 16) >= 1 && u32ScaleY < 0x20000) // second line
+               pDest = &pPage->ucPixels[pPage->iPitch];
+       }
+    pPage->u32Accum += u32ScaleY;
+    if ((bClipped && y < pPage->window.y) || (y & 1 && u32ScaleY < 0x4000))
+    {
+        pPage->ucRowState &= ~TIFF_ROW_LAST; // the buffer doesn't have this line
+        return 1; // no need to draw anything, if shrinking too tiny, skip every line
+    }
+    //
+    // Blank lines and lines which repeat the previous one don't need to be
+    // drawn again; the row which was just sent can often be sent again as-is
+    //
+    ucLineType = pPage->ucLineType;
+    if (bInvert && ucLineType == TIFF_LINE_WHITE)
+        ucLineType = TIFF_LINE_NEW; // it's all black
+    if (pPage->ucRowState & TIFF_ROW_SENT) // the buffer still holds the last output
+    {
+        if (ucLineType == TIFF_LINE_WHITE && (pPage->ucRowState & TIFF_ROW_WHITE))
+        {
+            if (ucPixelType == TIFF_PIXEL_1BPP)
+                pPage->ucRowState = TIFF_ROW_WHITE; // start the next row with it
+            // the gray/color output of a white pair is sent again
+        }
+        else if (ucLineType == TIFF_LINE_SAME && pPage->ucRowState == (TIFF_ROW_LAST | TIFF_ROW_SENT))
+        {
+            pPage->ucRowState = TIFF_ROW_LAST; // the next row starts as this line
+        }
+        else
+        {
+            len = (ucPixelType >= TIFF_PIXEL_2BPP) ? pPage->iPitch*2 : pPage->iPitch;
+            if (len <= PIXEL_BUF_SIZE(pPage))
+                memset(pPage->ucPixels, 0xff, len); // start as 0xff (white)
+            pPage->ucRowState = TIFF_ROW_WHITE;
+        }
+    }
+    if (ucLineType == TIFF_LINE_WHITE || (ucLineType == TIFF_LINE_SAME && (pPage->ucRowState & TIFF_ROW_LAST)))
+    {
+        if (!(pPage->ucRowState & TIFF_ROW_WHITE))
+            pPage->ucRowState &= ~TIFF_ROW_LAST; // a white line on top of a previous one
+        else if (ucPixelType == TIFF_PIXEL_1BPP)
+            pPage->ucRowState |= TIFF_ROW_LAST;
+        xright = 0; // nothing new to draw
+    }
+    else
+    {
+        pPage->ucRowState = (ucPixelType == TIFF_PIXEL_1BPP && (pPage->ucRowState & TIFF_ROW_WHITE)) ? TIFF_ROW_LAST : 0;
+    }
+       iNext = *pCurFlips++; // start of the first black run
+       if (bInvert) // the white runs are the ones between the black runs
+       {
+           if (iNext == 0) // the line starts with a black run
+               iNext = *pCurFlips++;
+           else
+           {
+               pCurFlips--;
+               iNext = 0;
+           }
+       }
+       x = 0;
+       while (x < xright) // while the scaled x is within the window bounds
+        {
+            x = iNext; // black starting point
+            if (x >= pPage->iWidth) // the end of the line
+               break;
+            run = *pCurFlips++ - x; // get the black run
+            iNext = *pCurFlips++;
+            if (run < 0) {
+                return 0; // an error occurred - the run should never be negative in length
+            }
+            x -= iStart;
+          if (x >= xright || run == 0)
+             break;
+            if ((x + run) > 0) { /* If the run is visible, draw it */
+                if (x < 0) {
+                    run += x; /* draw only visible part of run */
+                    x = 0;
+                }
+          /* Scale the starting x and run down to size */
+                if ((x + run) > xright) { /* Don't let it go off right edge */
+                    run = xright - x;
+                }
+             sx = TIFFScale(x, u32ScaleFactor);
+             srun = TIFFScale(run, u32ScaleFactor);
+             if (srun < 1) /* Always draw at least one pixel */
+                srun = 1;
+             /* Draw this run */
+             lBit = 0xff << (8 - (sx & 7));
+             rBit = 0xff >> ((sx + srun) & 7);
+             len = ((sx+srun)>>3) - (sx >> 3);
+             p = &pDest[sx >> 3];
+             if (len == 0)
+                {
+                lBit |= rBit;
+                *p &= lBit;
+                }
+             else
+                {
+                *p++ &= lBit;
+#ifdef TIFF_SIMD
+                if (len > 32) { // long runs use the vector fill
+                   TIFF_ZERO_FILL(p, len-1);
+                   p += len-1;
+                   len = 1;
+                }
+#endif
+                while (len > 1)
+                   {
+                   *p++ = 0;
+                   len--;
+                   }
+                *p &= rBit;
+                }
+             }
+          } /* while drawing line */
+    // When the line is at least as tall as an output line, it's both of the pair
+    if (ucPixelType >= TIFF_PIXEL_2BPP && u32ScaleY >= 0x20000 && !(pPage->ucRowState & TIFF_ROW_WHITE) && pPage->iPitch*2 <= PIXEL_BUF_SIZE(pPage))
+        memcpy(&pPage->ucPixels[pPage->iPitch], pPage->ucPixels, pPage->iPitch);
+    obgd.ucLast = 0;
+    obgd.ucPixelType = ucPixelType;
+    if (y == pPage->iHeight-1 && ucPixelType >= TIFF_PIXEL_2BPP) // antialiased image at the last line, force a final draw
+    {
+        pPage->u32Accum = 0x20000;
+        obgd.ucLast = 1;
+    }
+    if (ucPixelType >= TIFF_PIXEL_2BPP)
+    {
+        if ((pPage->u32Accum >> 16) >= 2)
+        {
+            // Time to output the two lines as scale-to-gray
+            // Convert the stretched pixels to 2-bit grayscale
+            if (pPage->ucRowState & TIFF_ROW_SENT) // another white pair, same output
+            {
+                obgd.pPixels = pPage->ucPixels;
+            }
+            else if (ucPixelType == TIFF_PIXEL_2BPP)
+            {
+                obgd.pPixels = pPage->ucPixels;
+                TIFF_SCALE2GRAY(pPage->ucPixels, obgd.iScaledWidth*2, pPage->iPitch);
+            }
+            else if (ucPixelType == TIFF_PIXEL_4BPP)
+            {
+                obgd.pPixels = pPage->window.p4BPP; // need a larger buffer for 4-bit pixels
+                TIFF_SCALE2GRAY4BPP(pPage->ucPixels, pPage->window.p4BPP, obgd.iScaledWidth*2, pPage->iPitch);
+            }
+            else // Convert to RGB565 color output
+            {
+               Scale2Color(pPage, obgd.iScaledWidth*2); 
+               obgd.pPixels = pPage->ucPixels;
+            }
+            // When stretching the image, we may need to repeat lines
+            while (pPage->u32Accum >= 0x20000)
             {
                 obgd.y = pPage->y;
                 (*pPage->pfnDraw)(&obgd); // callback
                 pPage->y++;
                 pPage->u32Accum -= 0x20000;
             }
-            if (pPage->iPitch*2 < MAX_BUFFERED_PIXELS)
-                memset(pPage->ucPixels, 0xff, pPage->iPitch*2); // start as 0xff (white)
+            if (!(pPage->ucRowState & TIFF_ROW_WHITE))
+            {
+                if (pPage->iPitch*2 <= PIXEL_BUF_SIZE(pPage))
+                    memset(pPage->ucPixels, 0xff, pPage->iPitch*2); // start as 0xff (white)
+                pPage->ucRowState = TIFF_ROW_WHITE;
+            }
+            else if (ucPixelType != TIFF_PIXEL_4BPP) // 2-bpp and RGB565 are converted in place
+                pPage->ucRowState |= TIFF_ROW_SENT;
         }
     }
     else if ((pPage->u32Accum >> 16) >= 1) // time to output the 1 line
@@ -982,20 +2443,37 @@ static int TIFFDrawLine(TIFFIMAGE *pPage, int y, int16_t *pCurFlips)
             pPage->y++;
             pPage->u32Accum -= 0x10000;
         }
-        if (pPage->iPitch < MAX_BUFFERED_PIXELS)
-            memset(pPage->ucPixels, 0xff, pPage->iPitch); // start as 0xff (white)
+        pPage->ucRowState |= TIFF_ROW_SENT; // cleared when a different line comes along
     }
     return 1; // continue decoding
+} /* TIFFDrawLineCore() */
+
+static int TIFFDrawLine(TIFFIMAGE *pPage, int y, TIFF_FLIP *pCurFlips)
+{
+    return TIFFDrawLineCore(pPage, y, pCurFlips, pPage->window.ucPixelType, pPage->window.iScale, pPage->window.iScaleY, 1);
 } /* TIFFDrawLine() */
 
+//
+// Some files may have leading 0's that would confuse the decoder
+// Valid G4 data can't begin with a 0 (but G3 data and some streams begin with an EOL)
+// returns where the data starts in the iLen bytes at pBuf
+//
+static uint8_t * TIFFSkipZeros(TIFFIMAGE *pPage, uint8_t *pBuf, int iLen)
+{
+    uint8_t *pBufEnd = &pBuf[iLen];
+
+    while (pBuf < pBufEnd && pBuf[0] == 0 && pPage->ucCompression != TIFF_COMPRESSION_CCITT_T4 && !(pPage->ucCCITT & TIFF_CCITT_END_OF_LINE))
+    { pBuf++; }
+    return pBuf;
+} /* TIFFSkipZeros() */
 //
 // Initialize internal structures to decode the image
 //
 static void Decode_Begin(TIFFIMAGE *pPage)
 {
     int i, xsize;
-    int16_t *CurFlips, *RefFlips;
-    uint8_t *pBuf, *pBufEnd;
+    TIFF_FLIP *CurFlips, *RefFlips;
+    uint8_t *pBuf;
     
     xsize = pPage->iWidth;
     
@@ -1011,21 +2489,19 @@ static void Decode_Begin(TIFFIMAGE *pPage)
     /* Prefill both current and reference lines with 7fff to prevent it from
        walking off the end if the data gets bunged and the current X is > XSIZE
        3-16-94 */
-     CurFlips[i] = RefFlips[i] = 0x7fff;
-     CurFlips[i+1] = RefFlips[i+1] = 0x7fff;
+     CurFlips[i] = RefFlips[i] = TIFF_FLIP_MAX;
+     CurFlips[i+1] = RefFlips[i+1] = TIFF_FLIP_MAX;
+    // These are never overwritten; they stop the reference line walks
+    // (and the drawing of an unterminated line) if the data is corrupt
+     for (i=TIFF_FLIPS_PER_LINE(xsize)-4; i<TIFF_FLIPS_PER_LINE(xsize); i++)
+         CurFlips[i] = RefFlips[i] = TIFF_FLIP_MAX;
     
     pPage->pCur = CurFlips;
     pPage->pRef = RefFlips;
+    pPage->iFlipCount = 0;
+    pPage->iDamagedRows = 0;
 
-    pBuf = pPage->pBuf = pPage->ucFileBuf;
-//
-// Some files may have leading 0's that would confuse the decoder
-// Valid G4 data can't begin with a 0
-//
-    pBufEnd = &pBuf[128]; // DEBUG
-    while (pBuf < pBufEnd && pBuf[0] == 0)
-    { pBuf++; }
-    
+    pBuf = TIFFSkipZeros(pPage, pPage->ucFileBuf, 128);
     pPage->pBuf = pBuf;
     pPage->ulBits = TIFFMOTOLONG(pBuf); // load 32 bits to start
     pPage->ulBitOff = pPage->iVLCOff = 0;
@@ -1035,105 +2511,176 @@ static void Decode_Begin(TIFFIMAGE *pPage)
 
 #ifdef NO_RAM
 //
-// Find the X coordinate of the next color change
+// Count the leading zeros of a non-zero 32-bit value
 //
-int NextColorChange(uint8_t *pData, int iStart, int iWidth, uint8_t ucColor)
+#if defined( __GNUC__ )
+#define TIFF_CLZ32(u) (__builtin_clzl((unsigned long)(u)) - (int)(sizeof(unsigned long)*8 - 32))
+#else
+static int TIFFClz32(uint32_t u)
+{
+    int n = 0;
+
+    if (!(u & 0xffff0000)) { n += 16; u <<= 16; }
+    if (!(u & 0xff000000)) { n += 8; u <<= 8; }
+    if (!(u & 0xf0000000)) { n += 4; u <<= 4; }
+    if (!(u & 0xc0000000)) { n += 2; u <<= 2; }
+    if (!(u & 0x80000000)) n++;
+    return n;
+} /* TIFFClz32() */
+#define TIFF_CLZ32(u) TIFFClz32(u)
+#endif
+//
+// Find the first pixel at or after x which is white (u32Invert = 0)
+// or black (u32Invert = 0xffffffff)
+// Looks at the next 32 pixels at a time with count-leading-zeros
+//
+static TIFF_ALWAYS_INLINE int FindPixel(uint8_t *pData, int x, int iWidth, uint32_t u32Invert)
 {
     uint8_t *s;
-    uint8_t uc, ucMask;
-    int x = iStart;
-    
-    if (!pData) return iWidth;
-    ucMask = 0x80 >> (iStart & 7);
-    s = pData + (iStart >> 3);
-    uc = s[0];
-    if (!ucColor) { // current pixel is black, search for white
-        while (x < iWidth && !(uc & ucMask)) { // get out from under overhang
-            x++;
-            ucMask >>= 1;
-            if (ucMask == 0) {
-                s++;
-                uc = s[0];
-                ucMask = 0x80;
-            }
-        }
-        while (x < iWidth && (uc & ucMask)) {
-            if (uc == 0xff) { // we could test remaining bits, but it's not worth it
-                x += (8-(x & 7)); // skip whole or partial byte
-                s++;
-                uc = s[0];
-                ucMask = 0x80;
-            } else {
-                x++;
-                ucMask >>= 1;
-                if (ucMask == 0) {
-                    ucMask = 0x80;
-                    s++;
-                    uc = s[0];
-                }
-            }
-        }
-    } else { // current pixel is white, search for black
-        while (x < iWidth && (uc & ucMask)) { // get out from under overhang
-            x++;
-            ucMask >>= 1;
-            if (ucMask == 0) {
-                s++;
-                uc = s[0];
-                ucMask = 0x80;
+    uint32_t u32;
+    int iLast = (iWidth - 1) >> 3; // last byte of the line
+
+    while (x < iWidth) {
+        s = &pData[x >> 3];
+        if ((x >> 3) + 3 <= iLast) { // 4 bytes left on the line
+            u32 = ((uint32_t)s[0] << 24) | ((uint32_t)s[1] << 16) | ((uint32_t)s[2] << 8) | s[3];
+            u32 = (u32 ^ u32Invert) << (x & 7); // 1 bits = the color we want
+            if (u32) {
+                x += TIFF_CLZ32(u32);
+                break;
             }
-        }
-        while (x < iWidth && !(uc & ucMask)) {
-            if (uc == 0) { // we could test remaining bits, but it's not worth it
-                x += (8-(x & 7)); // skip whole or partial byte
-                s++;
-                uc = s[0];
-                ucMask = 0x80;
-            } else {
-                x++;
-                ucMask >>= 1;
-                if (ucMask == 0) {
-                    ucMask = 0x80;
-                    s++;
-                    uc = s[0];
-                }
+            x = (x & ~7) + 32;
+        } else { // the last few bytes
+            u32 = ((s[0] ^ u32Invert) << (24 + (x & 7))) & 0xff000000;
+            if (u32) {
+                x += TIFF_CLZ32(u32);
+                break;
             }
+            x = (x & ~7) + 8;
         }
     }
-    if (x > iWidth) x = iWidth;
-    return x;
+    return (x < iWidth) ? x : iWidth;
+} /* FindPixel() */
+//
+// Find the X coordinate of the next color change
+// (skip any pixels of the other color, then the current color)
+//
+int NextColorChange(uint8_t *pData, int iStart, int iWidth, uint8_t ucColor)
+{
+    int x;
+
+    if (!pData) return iWidth;
+    if (iStart < 0) iStart = 0; // corrupt data
+    if (ucColor) { // black, skip white then black
+        x = FindPixel(pData, iStart, iWidth, 0xffffffff);
+        return FindPixel(pData, x, iWidth, 0);
+    }
+    x = FindPixel(pData, iStart, iWidth, 0);
+    return FindPixel(pData, x, iWidth, 0xffffffff);
 } /* NextColorChange() */
 
 //
 // Draw a run of pixels in the given color
+// Long runs are drawn 32-bits at a time
 //
 void DrawRun(uint8_t *pData, int iStart, int iEnd, uint8_t ucColor)
 {
-    int iLen = iEnd - iStart;
-    uint8_t ucMask, *d;
+    uint8_t ucLeft, ucRight, *d, *dEnd;
     
-    if (!ucColor) return; // no need to draw white
+    if (!ucColor || iEnd <= iStart) return; // no need to draw white
     d = pData + (iStart >> 3);
-    ucMask = 0x80 >> (iStart & 7);
-    
-  // draw black
-    while (iLen > 0) {
-        // try to draw a whole byte at a time
-        if (iLen >= 8 && ucMask == 0x80) {
+    dEnd = pData + (iEnd >> 3); // byte with the first pixel after the run
+    ucLeft = 0xff >> (iStart & 7); // pixels to draw in the first byte
+    ucRight = 0xff >> (iEnd & 7); // pixels to keep in the last byte
+    if (d == dEnd) { // starts and ends in the same byte
+        d[0] &= ~(ucLeft & ~ucRight);
+        return;
+    }
+    *d++ &= ~ucLeft;
+    if (dEnd - d >= 8) { // draw black
+        while ((uintptr_t)d & 3)
             *d++ = 0;
-            iLen -= 8;
-        } else {
-       	    d[0] &= ~ucMask;
-       	    iLen--;
-       	    ucMask >>= 1;
-       	    if (ucMask == 0) {
-       	    ucMask = 0x80;
-       	    d++;
-            }
-	}
-    } // while drawing
+        while (d + 4 <= dEnd) {
+            *(uint32_t *)d = 0;
+            d += 4;
+        }
+    }
+    while (d < dEnd)
+        *d++ = 0;
+    if (iEnd & 7)
+        d[0] &= ucRight;
 } /* DrawRun() */
 
+#ifdef TIFF_FLIP_CACHE
+//
+// Record a black run of the line being decoded
+// Adjacent runs are merged, so the entries are the color changes of the line
+// (even = white to black, odd = black to white). Once the cache is full the
+// line is marked as partial; the entries so far are still all of its changes
+// up to the last one.
+//
+static void TIFFCacheRun(TIFFFLIPCACHE *pCache, int iStart, int iEnd, int iWidth, int *pHigh)
+{
+    int16_t *pFlips = pCache->sFlips[pCache->ucCur];
+    int n = pCache->sCount[pCache->ucCur];
+
+    if (iEnd > iWidth) iEnd = iWidth;
+    if (iEnd <= iStart || n < 0) return;
+    if (iStart < *pHigh) { // out of order (corrupt data), don't use this line
+        pCache->sCount[pCache->ucCur] = -1;
+        return;
+    }
+    if (n && !(n & 1) && pFlips[n-1] == iStart) { // continues the last run
+        pFlips[n-1] = (int16_t)iEnd;
+    } else if (!pCache->bPartial[pCache->ucCur]) {
+        if (n + 2 <= TIFF_FLIP_CACHE) {
+            pFlips[n] = (int16_t)iStart;
+            pFlips[n+1] = (int16_t)iEnd;
+            pCache->sCount[pCache->ucCur] = (int16_t)(n + 2);
+        } else {
+            pCache->bPartial[pCache->ucCur] = 1;
+        }
+    }
+    *pHigh = iEnd;
+} /* TIFFCacheRun() */
+//
+// Same result as NextColorChange(), but from the cached changes of the
+// reference line; *pIndex remembers the position between calls
+//
+static TIFF_ALWAYS_INLINE int CachedColorChange(TIFFFLIPCACHE *pCache, int *pIndex, uint8_t *pRef, int a0, int iWidth, uint8_t ucColor)
+{
+    int iRef = pCache->ucCur ^ 1;
+    int16_t *pFlips = pCache->sFlips[iRef];
+    int n = pCache->sCount[iRef];
+    int i = *pIndex;
+
+    if (a0 < 0) a0 = 0; // corrupt data
+    while (i > 0 && pFlips[i-1] > a0) // a0 moved left (corrupt data)
+        i--;
+    while (i < n && pFlips[i] <= a0)
+        i++;
+    *pIndex = i;
+    if ((i & 1) != (ucColor != 0)) // want the other direction of change
+        i++;
+    if (i < n)
+        return pFlips[i];
+    if (pCache->bPartial[iRef]) // past the end of the cached changes
+        return NextColorChange(pRef, a0, iWidth, ucColor);
+    return iWidth;
+} /* CachedColorChange() */
+#endif // TIFF_FLIP_CACHE
+
+//
+// Runs from corrupt data are kept within the line
+//
+#define CLIP_RUN(x) ((x) < 0 ? 0 : ((x) > xsize ? xsize : (x)))
+#ifdef TIFF_FLIP_CACHE
+#define REF_CHANGE(x, c) (bRefCached ? CachedColorChange(&pPage->cache, &iRefIndex, pRef, x, xsize, (uint8_t)(c)) : NextColorChange(pRef, x, xsize, (uint8_t)(c)))
+#define DRAW_RUN(s, e, c) do { if ((uint8_t)(c)) { DrawRun(pCur, CLIP_RUN(s), CLIP_RUN(e), 1); TIFFCacheRun(&pPage->cache, CLIP_RUN(s), CLIP_RUN(e), xsize, &iHigh); } } while (0)
+#else
+#define REF_CHANGE(x, c) NextColorChange(pRef, x, xsize, (uint8_t)(c))
+#define DRAW_RUN(s, e, c) DrawRun(pCur, CLIP_RUN(s), CLIP_RUN(e), (uint8_t)(c))
+#endif
 //
 // Decode a single line of the image directly into the given buffer(s)
 //
@@ -1142,9 +2689,17 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
     signed int a0, a0_c; //, b1;
     int x, xsize, tot_run, tot_run1 = 0;
     int32_t sCode;
-    uint32_t lBits;
-    uint32_t ulBits, ulBitOff;
+    BIGUINT lBits, ulBits;
+    uint32_t ulBitOff;
     uint8_t *d, *pBuf, *pBufEnd;
+#ifdef TIFF_FLIP_CACHE
+    int iRefIndex = 0, iHigh = 0, bRefCached;
+
+    pPage->cache.ucCur ^= 1; // the last line becomes the reference line
+    pPage->cache.sCount[pPage->cache.ucCur] = 0;
+    pPage->cache.bPartial[pPage->cache.ucCur] = 0;
+    bRefCached = (pRef != NULL && pPage->cache.sCount[pPage->cache.ucCur ^ 1] >= 0);
+#endif
 
     ulBits = pPage->ulBits;
     ulBitOff = pPage->ulBitOff;
@@ -1166,11 +2721,11 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                ulBitOff &= 7;
                ulBits = TIFFMOTOLONG(pBuf);
            }
-           if ((int32_t)(ulBits << ulBitOff) < 0) { /* V(0) code */
+           if ((ulBits << ulBitOff) & TOP_BIT) { /* V(0) code */
                //a0 = *pRef++;
-               x = NextColorChange(pRef, a0, xsize, a0_c);
+               x = REF_CHANGE(a0, a0_c);
                ulBitOff++; // 1 bit
-               DrawRun(pCur, a0, x, a0_c);
+               DRAW_RUN(a0, x, a0_c);
                a0_c = 1 - a0_c; /* color change */
                //*pCur++ = a0;
                a0 = x;
@@ -1182,8 +2737,8 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                    case 1: /* V(-1) */
                    case 2: /* V(-2) */
                    case 3: /* V(-3) */
-                       x = NextColorChange(pRef, a0, xsize, a0_c) - sCode;
-                       DrawRun(pCur, a0, x, a0_c);
+                       x = REF_CHANGE(a0, a0_c) - sCode;
+                       DRAW_RUN(a0, x, a0_c);
                        a0 = x;
                        a0_c = 1-a0_c; /* color change */
                        break;
@@ -1191,8 +2746,8 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                    case 0x11: /* V(1) */
                    case 0x12: /* V(2) */
                    case 0x13: /* V(3) */
-                       x = NextColorChange(pRef, a0, xsize, a0_c) + (sCode & 7);
-                       DrawRun(pCur, a0, x, a0_c);
+                       x = REF_CHANGE(a0, a0_c) + (sCode & 7);
+                       DRAW_RUN(a0, x, a0_c);
                        a0 = x;
                        a0_c = 1-a0_c; /* color change */
                        break;
@@ -1225,22 +2780,26 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                            }
                            tot_run1 = sCode;
                        }
-                       DrawRun(pCur, a0, a0+tot_run, a0_c);
-                       DrawRun(pCur, a0+tot_run, a0+tot_run+tot_run1, 1-a0_c);
+                       DRAW_RUN(a0, a0+tot_run, a0_c);
+                       DRAW_RUN(a0+tot_run, a0+tot_run+tot_run1, 1-a0_c);
                        a0 += (tot_run + tot_run1);
                        break;
 
                    case 0x30: /* Pass code */
-                       x = NextColorChange(pRef, a0, xsize, a0_c);
-                       x = NextColorChange(pRef, x, xsize, 1-a0_c);
-                       DrawRun(pCur, a0, x, a0_c);
+                       x = REF_CHANGE(a0, a0_c);
+                       x = REF_CHANGE(x, 1-a0_c);
+                       DRAW_RUN(a0, x, a0_c);
                        a0 = x;
                        break;
 
                    case 0x40: /* Uncompressed mode */
-                       lBits = ulBits << ulBitOff;
-                       lBits &= 0xffc00000;
-                       if (lBits != 0x3c00000) { /* If not entering uncompressed mode */
+                       if (ulBitOff > (REGISTER_WIDTH - 11)) { // need the 10-bit extension + 1
+                           pBuf += (ulBitOff >> 3);
+                           ulBitOff &= 7;
+                           ulBits = TIFFMOTOLONG(pBuf);
+                       }
+                       lBits = (ulBits << ulBitOff) >> (REGISTER_WIDTH - 10);
+                       if (lBits != 0xf) { /* If not entering uncompressed mode */
                            pPage->iError = TIFF_DECODE_ERROR;
                            goto decode1z;
                        }
@@ -1272,7 +2831,7 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                        if (tot_run1 >= 6) { /* End of uncomp data */
                            tot_run += tot_run1 - 6; /* Get the number of extra 0's */
                            if (tot_run) { /* Something to store? */
-                               DrawRun(pCur, a0, a0+tot_run, a0_c);
+                               DRAW_RUN(a0, a0+tot_run, a0_c);
                                a0 += tot_run;
 //                               *pCur++ = a0;
                            }
@@ -1289,7 +2848,7 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                            break; /* Continue normal G4 decoding */
                        } else {
                            tot_run += tot_run1;
-                           DrawRun(pCur, a0, a0+tot_run, a0_c);
+                           DRAW_RUN(a0, a0+tot_run, a0_c);
                            a0 += tot_run; /* Add to current x */
                            tot_run = 0;
                            tot_run1 = 0;
@@ -1309,7 +2868,7 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
                        lBits = ulBits << ulBitOff;
                        if ((lBits & TOP_BIT) == TOP_BIT)
                            goto blkst;
-                       DrawRun(pCur, a0, a0+tot_run, a0_c);
+                       DRAW_RUN(a0, a0+tot_run, a0_c);
                        a0 += tot_run;
                        tot_run = 0;
                        goto whtst;
@@ -1330,49 +2889,86 @@ int TIFF_decode1Line(TIFFIMAGE *pPage, uint8_t *pCur, uint8_t *pRef)
            } /* Slow climb */
        }
 decode1z:
+#ifdef TIFF_FLIP_CACHE
+    if (pPage->iError != TIFF_SUCCESS) // don't trust this line as a reference
+        pPage->cache.sCount[pPage->cache.ucCur] = -1;
+#endif
     // Save the current VLC decoder state
     pPage->ulBits = ulBits;
     pPage->ulBitOff = ulBitOff;
     pPage->pBuf = pBuf;
     return pPage->iError;
 } /* TIFF_decode1Line() */
+#undef CLIP_RUN
+#undef REF_CHANGE
+#undef DRAW_RUN
 #endif // NO_RAM
 
 #ifndef NO_RAM
 //
 // Decode a single line of G4 data (private function)
+// The data is followed by the guard region (see TIFFSetGuard()), so
+// there's no need to check for the end of it while decoding
 //
 int Decode_one_line(TIFFIMAGE *pPage)
 {
     signed int a0, a0_c, a0_p, b1;
-    int16_t *pCur, *pRef, *RefFlips, *CurFlips;
+    TIFF_FLIP *pCur, *pRef, *RefFlips, *CurFlips, *pCurEnd;
     int xsize, tot_run, tot_run1 = 0;
     int32_t sCode;
-    uint32_t lBits;
-    uint32_t ulBits, ulBitOff;
-    uint8_t *pBuf, *pBufEnd;
+    BIGUINT lBits, ulBits;
+    uint32_t ulBitOff;
+#ifdef TIFF_WIDE_TABLES
+    uint32_t ulMode;
+#endif
+    int iCount, iRefCount;
+    uint8_t *pBuf;
 
     pCur = CurFlips = pPage->pCur;
     pRef = RefFlips = pPage->pRef;
     ulBits = pPage->ulBits;
     ulBitOff = pPage->ulBitOff;
     pBuf = pPage->pBuf;
-    pBufEnd = &pBuf[FILE_HIGHWATER];
+    iRefCount = pPage->iFlipCount; // the previous line is the reference line
+    pPage->iFlipCount = 0;
+    pPage->ucLineType = TIFF_LINE_NEW;
 
     a0 = -1;
     a0_c = 0; /* start just to left and white */
     xsize = pPage->iWidth;
+    pCurEnd = &CurFlips[xsize+2]; // a valid line can't get here before it ends
     
     while (a0 < xsize)   /* Decode this line */
        {
-       if (ulBitOff > (REGISTER_WIDTH-8)) // need at least 7 unused bits
+       if (pCur > pCurEnd) /* Corrupt data, too many flips */
+          {
+          pPage->iError = TIFF_DECODE_ERROR;
+          goto pilreadg4z;
+          }
+       if (ulBitOff > MODE_REFILL) // need enough unused bits for the mode lookup
           {
           pBuf += (ulBitOff >> 3);
           ulBitOff &= 7;
-          ulBits = TIFFMOTOLONG(pBuf);
+          ulBits = TIFFLOADBITS(pPage, pBuf);
           }
-       if ((int32_t)(ulBits << ulBitOff) < 0)  /* V(0) code */
+       if ((ulBits << ulBitOff) & TOP_BIT)  /* V(0) code */
           {
+#ifdef TIFF_V0_BURST
+          // count the leading 1's (the 0's shifted in at the bottom become 1's when
+          // inverted, so the count stops at the end of the valid bits)
+          iCount = TIFF_CLZ(~(ulBits << ulBitOff) | 1);
+          if (iCount > 1 && (pRef - RefFlips) + iCount <= iRefCount && (pCur - CurFlips) + iCount <= xsize && pRef[iCount-1] < xsize)
+             { /* the whole burst is inside the line, copy the reference flips */
+             memcpy(pCur, pRef, iCount * sizeof(TIFF_FLIP));
+             pCur += iCount;
+             pRef += iCount;
+             a0 = pCur[-1];
+             ulBitOff += iCount;
+             if (iCount & 1)
+                a0_c = 1 - a0_c; /* color change */
+             continue;
+             }
+#endif
           a0 = *pRef++;
           ulBitOff++; // 1 bit
           a0_c = 1 - a0_c; /* color change */
@@ -1380,11 +2976,25 @@ int Decode_one_line(TIFFIMAGE *pPage)
           }
        else /* Slow method */
           {
+#ifdef TIFF_WIDE_TABLES
+          ulMode = ulModeWide[(ulBits >> ((REGISTER_WIDTH - WIDE_BITS) - ulBitOff)) & WIDE_MASK];
+          ulBitOff += (ulMode & 0xf); /* length of the first code */
+          sCode = (ulMode >> 8) & 0xff;
+next_code:
+#else
           lBits = (ulBits >> ((REGISTER_WIDTH - 8) - ulBitOff)) & 0xfe; /* Only the first 7 bits are useful */
           sCode = pgm_read_byte(&code_table[lBits]); /* Get the code word */
           ulBitOff += pgm_read_byte(&code_table[lBits+1]); /* Get the code length */
+#endif
           switch (sCode)
              {
+#ifdef TIFF_WIDE_TABLES
+             case 0x10: /* V(0) as the second code of a pair */
+                a0 = *pRef++;
+                a0_c = 1 - a0_c; /* color change */
+                *pCur++ = a0;
+                break;
+#endif
              case 1: /* V(-1) */
              case 2: /* V(-2) */
              case 3: /* V(-3) */
@@ -1421,7 +3031,7 @@ int Decode_one_line(TIFFIMAGE *pPage)
                    a0_p = 0;
                 if (a0_c) /* Black case */
                    {
-                   CLIMBBLACK_NEW(pBuf, ulBitOff, ulBits, sCode)
+                   CLIMBBLACK(pBuf, ulBitOff, ulBits, sCode)
 //                     sCode = ClimbBlack(&bb);
                    if (sCode < 0)
                       {
@@ -1429,7 +3039,7 @@ int Decode_one_line(TIFFIMAGE *pPage)
                       goto pilreadg4z;
                       }
                    tot_run = sCode;
-                   CLIMBWHITE_NEW(pBuf, ulBitOff, ulBits, sCode)
+                   CLIMBWHITE(pBuf, ulBitOff, ulBits, sCode)
 //                     sCode = ClimbWhite(&bb);
                    if (sCode < 0)
                       {
@@ -1440,7 +3050,7 @@ int Decode_one_line(TIFFIMAGE *pPage)
                    }
                 else  /* White case */
                    {
-                    CLIMBWHITE_NEW(pBuf, ulBitOff, ulBits, sCode)
+                    CLIMBWHITE(pBuf, ulBitOff, ulBits, sCode)
 //                     sCode = ClimbWhite(&bb);
                    if (sCode < 0)
                       {
@@ -1448,7 +3058,7 @@ int Decode_one_line(TIFFIMAGE *pPage)
                       goto pilreadg4z;
                       }
                    tot_run = sCode;
-                   CLIMBBLACK_NEW(pBuf, ulBitOff, ulBits, sCode)
+                   CLIMBBLACK(pBuf, ulBitOff, ulBits, sCode)
 //                     sCode = ClimbBlack(&bb);
                    if (sCode < 0)
                       {
@@ -1471,9 +3081,14 @@ int Decode_one_line(TIFFIMAGE *pPage)
                 a0 = *pRef++;
                 break;
              case 0x40: /* Uncompressed mode */
-                lBits = ulBits << ulBitOff;
-                lBits &= 0xffc00000;
-                if (lBits != 0x3c00000)  /* If not entering uncompressed mode */
+                if (ulBitOff > (REGISTER_WIDTH - 11)) // need the 10-bit extension + 1
+                   {
+                   pBuf += (ulBitOff >> 3);
+                   ulBitOff &= 7;
+                   ulBits = TIFFLOADBITS(pPage, pBuf);
+                   }
+                lBits = (ulBits << ulBitOff) >> (REGISTER_WIDTH - 10);
+                if (lBits != 0xf)  /* If not entering uncompressed mode */
                    {
                    pPage->iError = TIFF_DECODE_ERROR;
                    goto pilreadg4z;
@@ -1483,18 +3098,13 @@ int Decode_one_line(TIFFIMAGE *pPage)
                 if ((ulBits << ulBitOff) & TOP_BIT)
                    goto blkst; /* Black start */
           whtst:
-                if (/*iCur >= xsize || */pBuf > pBufEnd)    /* Something is wrong, stop */
-                   {
-                   pPage->iError = TIFF_DECODE_ERROR;
-                   goto pilreadg4z;
-                   }
                 tot_run1++;
                 ulBitOff++;
                 if (ulBitOff > (REGISTER_WIDTH - 8))
                    {
                    pBuf += (ulBitOff >> 3);
                    ulBitOff &= 7;
-                   ulBits = TIFFMOTOLONG(pBuf);
+                   ulBits = TIFFLOADBITS(pPage, pBuf);
                    }
                 lBits = ulBits << ulBitOff;
                 if ((lBits & TOP_BIT) == 0)
@@ -1512,6 +3122,11 @@ int Decode_one_line(TIFFIMAGE *pPage)
                    if (tot_run) /* Something to store? */
                       {
                       a0 += tot_run;
+                      if (a0 > xsize || pCur > pCurEnd) /* Something is wrong, stop */
+                         {
+                         pPage->iError = TIFF_DECODE_ERROR;
+                         goto pilreadg4z;
+                         }
                       *pCur++ = a0;
                       }
    /* Get the last bit to see what the next color is */
@@ -1520,7 +3135,7 @@ int Decode_one_line(TIFFIMAGE *pPage)
                       {
                       pBuf += (ulBitOff >> 3);
                       ulBitOff &= 7;
-                      ulBits = TIFFMOTOLONG(pBuf);
+                      ulBits = TIFFLOADBITS(pPage, pBuf);
                       }
                    lBits = ulBits << ulBitOff;
                    lBits >>= (REGISTER_WIDTH - 1); /* Turn it into 0/1 for color */
@@ -1536,28 +3151,33 @@ int Decode_one_line(TIFFIMAGE *pPage)
                    {
                    tot_run += tot_run1;
                    a0 += tot_run; /* Add to current x */
+                   if (a0 > xsize || pCur > pCurEnd) /* Something is wrong, stop */
+                      {
+                      pPage->iError = TIFF_DECODE_ERROR;
+                      goto pilreadg4z;
+                      }
                    *pCur++ = a0;
                    tot_run = 0;
                    tot_run1 = 0;
                    }
           blkst:
-                if (/*iCur >= xsize || */ pBuf > pBufEnd)    /* Something is wrong, stop */
-                   {
-                   pPage->iError = TIFF_DECODE_ERROR;
-                   goto pilreadg4z;
-                   }
                 tot_run++;
                 ulBitOff++;
                 if (ulBitOff > (REGISTER_WIDTH - 8))
                    {
                    pBuf += (ulBitOff >> 3);
                    ulBitOff &= 7;
-                   ulBits = TIFFMOTOLONG(pBuf);
+                   ulBits = TIFFLOADBITS(pPage, pBuf);
                    }
                 lBits = ulBits << ulBitOff;
                 if ((lBits & TOP_BIT) == TOP_BIT)
                    goto blkst;
                 a0 += tot_run;
+                if (a0 > xsize || pCur > pCurEnd) /* Something is wrong, stop */
+                   {
+                   pPage->iError = TIFF_DECODE_ERROR;
+                   goto pilreadg4z;
+                   }
                 *pCur++ = a0;
                 tot_run = 0;
                 goto whtst;
@@ -1577,13 +3197,32 @@ int Decode_one_line(TIFFIMAGE *pPage)
                    pPage->iError = TIFF_DECODE_ERROR;
                    goto pilreadg4z;
                    }
-                goto pilreadg4z; /* Leave gracefully */
+                if (a0_c) /* end a black run at the right edge */
+                   *pCur++ = xsize;
+                goto pilreadg4end; /* Leave gracefully, the rest of the line is white */
              } /* switch */
+#ifdef TIFF_WIDE_TABLES
+          if ((ulMode >> 16) && a0 < xsize) /* 2nd vertical code from the same probe */
+             {
+             ulBitOff += (ulMode >> 4) & 0xf;
+             sCode = ulMode >> 16;
+             ulMode = 0;
+             goto next_code;
+             }
+#endif
           } /* Slow climb */
        }
     /*--- Convert flips data into run lengths ---*/
+pilreadg4end:
     *pCur++ = xsize;  /* Terminate the line properly */
     *pCur++ = xsize;
+    iCount = (int)(pCur - CurFlips);
+    pPage->iFlipCount = iCount;
+    // let TIFFDrawLine() know if there's nothing new to draw
+    if (CurFlips[0] >= xsize && CurFlips[1] == CurFlips[0])
+        pPage->ucLineType = TIFF_LINE_WHITE;
+    else if (iCount == iRefCount && memcmp(CurFlips, RefFlips, iCount * sizeof(TIFF_FLIP)) == 0)
+        pPage->ucLineType = TIFF_LINE_SAME;
 pilreadg4z:
     // Save the current VLC decoder state
     pPage->ulBits = ulBits;
@@ -1592,6 +3231,244 @@ pilreadg4z:
     return pPage->iError;
 } /* Decode_one_line() */
 //
+// Decode a single line of 1D (Modified Huffman) data (private function)
+// The line is a white run followed by alternating black and white runs
+//
+static int Decode_1D_line(TIFFIMAGE *pPage)
+{
+    TIFF_FLIP *pCur, *CurFlips, *pCurEnd;
+    int a0, xsize, iCount, iRefCount;
+    int32_t sCode;
+    BIGUINT ulBits;
+    uint32_t ulBitOff;
+    uint8_t *pBuf;
+
+    pCur = CurFlips = pPage->pCur;
+    ulBits = pPage->ulBits;
+    ulBitOff = pPage->ulBitOff;
+    pBuf = pPage->pBuf;
+    iRefCount = pPage->iFlipCount;
+    pPage->iFlipCount = 0;
+    pPage->ucLineType = TIFF_LINE_NEW;
+    xsize = pPage->iWidth;
+    pCurEnd = &CurFlips[xsize+2]; // a valid line can't get here before it ends
+    a0 = 0;
+    while (a0 < xsize)
+    {
+        CLIMBWHITE(pBuf, ulBitOff, ulBits, sCode)
+        if (sCode < 0) // bad code or an EOL in the middle of the line
+        {
+            pPage->iError = TIFF_DECODE_ERROR;
+            goto g3_1d_error;
+        }
+        a0 += sCode;
+        *pCur++ = a0;
+        if (a0 >= xsize)
+            break;
+        CLIMBBLACK(pBuf, ulBitOff, ulBits, sCode)
+        if (sCode < 0)
+        {
+            pPage->iError = TIFF_DECODE_ERROR;
+            goto g3_1d_error;
+        }
+        a0 += sCode;
+        *pCur++ = a0;
+        if (pCur > pCurEnd) // corrupt data, too many flips (e.g. 0-length runs)
+        {
+            pPage->iError = TIFF_DECODE_ERROR;
+            goto g3_1d_error;
+        }
+    }
+    if (a0 > xsize) // the runs don't add up to the width
+    {
+        pPage->iError = TIFF_DECODE_ERROR;
+        goto g3_1d_error;
+    }
+    *pCur++ = xsize;  /* Terminate the line properly */
+    *pCur++ = xsize;
+    iCount = (int)(pCur - CurFlips);
+    pPage->iFlipCount = iCount;
+    if (CurFlips[0] >= xsize && CurFlips[1] == CurFlips[0])
+        pPage->ucLineType = TIFF_LINE_WHITE;
+    else if (iCount == iRefCount && memcmp(CurFlips, pPage->pRef, iCount * sizeof(TIFF_FLIP)) == 0)
+        pPage->ucLineType = TIFF_LINE_SAME;
+g3_1d_error:
+    pPage->ulBits = ulBits;
+    pPage->ulBitOff = ulBitOff;
+    pPage->pBuf = pBuf;
+    return pPage->iError;
+} /* Decode_1D_line() */
+//
+// Skip the EOL (11 or more 0's and a 1) at the current position or, if
+// bSearch is set, the first one after it
+// returns 1 if one was found; otherwise the position doesn't change
+//
+static int TIFFFindEOL(TIFFIMAGE *pPage, int bSearch)
+{
+    uint8_t *pBuf, *pEnd = pPage->pDataEnd;
+    uint32_t ulBitOff;
+    int iZeros = 0;
+
+    pBuf = pPage->pBuf + (pPage->ulBitOff >> 3);
+    ulBitOff = pPage->ulBitOff & 7;
+    while (pBuf < pEnd)
+    {
+        if (ulBitOff == 0 && pBuf[0] == 0) // a byte of fill
+        {
+            iZeros += 8;
+            pBuf++;
+            continue;
+        }
+        if (pBuf[0] & (0x80 >> ulBitOff))
+        {
+            if (iZeros >= 11)
+            {
+                ulBitOff++; // skip the 1
+                pPage->pBuf = pBuf + (ulBitOff >> 3);
+                pPage->ulBitOff = ulBitOff & 7;
+                pPage->ulBits = TIFFLOADBITS(pPage, pPage->pBuf);
+                return 1;
+            }
+            if (!bSearch)
+                return 0;
+            iZeros = 0;
+        }
+        else
+        {
+            iZeros++;
+        }
+        if (++ulBitOff == 8)
+        {
+            ulBitOff = 0;
+            pBuf++;
+        }
+    }
+    return 0; // the data ended first
+} /* TIFFFindEOL() */
+//
+// Decode a single line of G3 (T.4) or Modified Huffman data, or of a G4 line
+// with the EOLs or byte alignment of a CCITTFaxDecode stream (private function)
+// T.4 lines start with an EOL, followed by a tag bit (1 = 1D, 0 = 2D) when
+// the file has 2D lines. The 2D lines are coded the same way as G4 lines.
+// A damaged T.4 line is replaced by the previous line and decoding resumes
+// at the next EOL. Valid codes never have 11 0's in a row, so the search
+// starts from the beginning of the line in case the decoder went past it.
+// A line which starts with an EOL is the end of the block (EOFB or RTC).
+//
+static int Decode_G3_line(TIFFIMAGE *pPage)
+{
+    int rc, b2D, iRefCount = pPage->iFlipCount;
+    uint8_t *pStart;
+    uint32_t ulStartOff;
+
+    // Byte aligned lines which always have an EOL get their fill bits
+    // skipped with it; otherwise a code could look like an EOL after them
+    if (pPage->ucAligned && !(pPage->ucCCITT & TIFF_CCITT_END_OF_LINE))
+    {
+        pPage->pBuf += ((pPage->ulBitOff + 7) >> 3);
+        pPage->ulBitOff = 0;
+        pPage->ulBits = TIFFLOADBITS(pPage, pPage->pBuf);
+    }
+    b2D = (pPage->ucCompression == TIFF_COMPRESSION_CCITT_T6);
+    if (pPage->ucCompression == TIFF_COMPRESSION_CCITT_T4 || (pPage->ucCCITT & TIFF_CCITT_END_OF_LINE))
+    {
+        // the first line of a file may not have one, but a stream can require it
+        TIFFFindEOL(pPage, pPage->ucCCITT & TIFF_CCITT_END_OF_LINE);
+    }
+    if (pPage->ucCompression == TIFF_COMPRESSION_CCITT_T4 && (pPage->ucT4Options & TIFF_T4_2D))
+    {
+        if (pPage->ulBitOff > (REGISTER_WIDTH - 8))
+        {
+            pPage->pBuf += (pPage->ulBitOff >> 3);
+            pPage->ulBitOff &= 7;
+            pPage->ulBits = TIFFLOADBITS(pPage, pPage->pBuf);
+        }
+        b2D = !((pPage->ulBits << pPage->ulBitOff) & TOP_BIT);
+        pPage->ulBitOff++;
+    }
+    if ((pPage->ucCCITT & TIFF_CCITT_END_OF_BLOCK) && TIFFFindEOL(pPage, 0))
+        return TIFF_END_OF_BLOCK; // EOFB or RTC, the remaining lines aren't coded
+    pStart = pPage->pBuf;
+    ulStartOff = pPage->ulBitOff;
+    rc = (b2D) ? Decode_one_line(pPage) : Decode_1D_line(pPage);
+    if (rc == TIFF_SUCCESS)
+        return rc;
+    pPage->pBuf = pStart;
+    pPage->ulBitOff = ulStartOff;
+    if (pPage->ucCompression == TIFF_COMPRESSION_CCITT_RLE || (pPage->ucCompression == TIFF_COMPRESSION_CCITT_T6 && !(pPage->ucCCITT & TIFF_CCITT_END_OF_LINE)))
+        return rc; // no EOLs to resynchronize with
+    if (pPage->iMaxDamagedRows >= 0 && ++pPage->iDamagedRows > pPage->iMaxDamagedRows)
+        return rc; // DamagedRowsBeforeError
+    if (!TIFFFindEOL(pPage, 1))
+        return rc; // the data ended
+    if (iRefCount == 0) // no previous line, make it white
+    {
+        pPage->pCur[0] = pPage->pCur[1] = (TIFF_FLIP)pPage->iWidth;
+        iRefCount = 2;
+        pPage->ucLineType = TIFF_LINE_WHITE;
+    }
+    else
+    {
+        memcpy(pPage->pCur, pPage->pRef, iRefCount * sizeof(TIFF_FLIP));
+        pPage->ucLineType = TIFF_LINE_SAME;
+    }
+    pPage->iFlipCount = iRefCount;
+    pPage->iError = TIFF_SUCCESS;
+    return TIFF_SUCCESS;
+} /* Decode_G3_line() */
+//
+// Decode the next line with the coding of the image (private function)
+// G4 lines only need the wrapper for the options of a raw stream
+//
+static TIFF_ALWAYS_INLINE int TIFFDecodeLine(TIFFIMAGE *pPage)
+{
+    if (pPage->ucCompression == TIFF_COMPRESSION_CCITT_RLE || pPage->ucCompression == TIFF_COMPRESSION_CCITT_T4 || pPage->ucAligned || (pPage->ucCCITT & (TIFF_CCITT_END_OF_LINE | TIFF_CCITT_END_OF_BLOCK)))
+        return Decode_G3_line(pPage);
+    return Decode_one_line(pPage);
+} /* TIFFDecodeLine() */
+//
+// Set up the coding of a CCITTFaxDecode stream (after openRAW())
+// K < 0 is G4, K = 0 has only 1D lines and K > 0 mixes 1D and 2D
+// lines, each one preceded by a tag bit like T.4 with the 2D option
+//
+static void TIFFSetCCITT(TIFFIMAGE *pImage, int iK, int iOptions, int iDamagedRows)
+{
+    if (iK < 0)
+        pImage->ucCompression = TIFF_COMPRESSION_CCITT_T6;
+    else
+        pImage->ucCompression = TIFF_COMPRESSION_CCITT_T4; // EOLs are optional
+    pImage->ucT4Options = (iK > 0) ? TIFF_T4_2D : 0;
+    pImage->ucCCITT = (uint8_t)iOptions;
+    pImage->ucAligned = (iOptions & TIFF_CCITT_BYTE_ALIGN) != 0;
+    if (iOptions & TIFF_CCITT_BLACK_IS_1)
+        pImage->ucPhotometric = TIFF_PHOTOMETRIC_BLACKISZERO;
+    pImage->iMaxDamagedRows = (iDamagedRows < 0) ? 0 : iDamagedRows;
+} /* TIFFSetCCITT() */
+//
+// Set the vertical scale after setDrawParameters() set both of them
+// A yscale of 0 or less scales the height by XResolution / YResolution
+// so that the pixels come out square (e.g. 204x98 dpi fax pages)
+// A ratio beyond 16:1 is taken as a bad tag and ignored
+//
+static void TIFFSetScaleY(TIFFIMAGE *pImage, float yscale)
+{
+    uint64_t u64Scale;
+    uint32_t u32XRes = pImage->u32XRes, u32YRes = pImage->u32YRes;
+
+    if (yscale > 0.0f)
+    {
+        if (yscale > (float)TIFF_MAX_SCALE / 65536.0f)
+            pImage->window.iScaleY = TIFF_MAX_SCALE;
+        else
+            pImage->window.iScaleY = (uint32_t)(yscale * 65536.0f); // convert to uint32
+    }
+    else if (u32XRes && u32YRes && (uint64_t)u32XRes * 16 >= u32YRes && (uint64_t)u32YRes * 16 >= u32XRes)
+    {
+        u64Scale = ((uint64_t)pImage->window.iScale * u32XRes) / u32YRes;
+        pImage->window.iScaleY = (u64Scale > TIFF_MAX_SCALE) ? TIFF_MAX_SCALE : (uint32_t)u64Scale;
+    }
+} /* TIFFSetScaleY() */
+//
 // Add compressed data to the internal buffer
 // returns amount of data space available if pData is NULL
 // otherwise returns 0 for success, -1 for failure
@@ -1614,14 +3491,9 @@ static int Add_Data(TIFFIMAGE *pPage, uint8_t *pData, int iLen)
         pPage->pBuf = pPage->ucFileBuf; // reset pointer to start of buffer
         memcpy(&pPage->ucFileBuf[pPage->iVLCSize], pData, iLen); // copy new data on the end of the existing data
         if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
-        {
-            for (i=0; i<iLen; i++)
-            {
-                uint8_t c = pPage->ucFileBuf[i+pPage->iVLCSize];
-                pPage->ucFileBuf[i+pPage->iVLCSize] = pgm_read_byte(&ucMirror[c]);
-            }
-        }
+            TIFF_MIRROR(&pPage->ucFileBuf[pPage->iVLCSize], iLen);
         pPage->iVLCSize += iLen; // adjust total number of compressed bytes in the buffer
+        TIFFSetGuard(pPage);
         // make sure we load some data into the state variables
         pPage->ulBits = TIFFMOTOLONG(pPage->pBuf);
         return TIFF_SUCCESS; // success
@@ -1639,12 +3511,15 @@ static void Decode_Inc_Begin(TIFFIMAGE *pPage, int iWidth, int iHeight, uint8_t
     pPage->iError = 0;
     pPage->u32Accum = 0;
     memset(&pPage->window, 0, sizeof(pPage->window));
-    pPage->window.iScale = 65536;
+    pPage->window.iScale = pPage->window.iScaleY = 65536;
     pPage->window.iWidth = iWidth;
     pPage->window.iHeight = iHeight;
-    Decode_Begin(pPage);
-    pPage->pBuf = pPage->ucFileBuf;
+    if (TIFFAllocBuffers(pPage)) // otherwise decodeInc() returns the error
+        Decode_Begin(pPage);
+    pPage->pBuf = pPage->pVLC = pPage->ucFileBuf;
+    pPage->iVLCBufSize = TIFF_FILE_BUF_SIZE;
     pPage->iVLCSize = 0;
+    TIFFSetGuard(pPage);
 } /* Decode_Inc_Begin() */
 
 //
@@ -1652,16 +3527,21 @@ static void Decode_Inc_Begin(TIFFIMAGE *pPage, int iWidth, int iHeight, uint8_t
 //
 static int Decode_Inc(TIFFIMAGE *pPage, int bHasMoreData)
 {
-    int rc = TIFF_SUCCESS;
-    int16_t *t1;
+    int rc = TIFF_SUCCESS, iMargin;
+    TIFF_FLIP *t1;
     uint8_t *pBufEnd;
     
-    pBufEnd = &pPage->ucFileBuf[pPage->iVLCSize] - (pPage->iWidth/4); // set limit at 2x uncompressed line size
+    if (pPage->iError != TIFF_SUCCESS) // e.g. no memory for the buffers
+        return pPage->iError;
+    iMargin = pPage->iWidth/4; // set limit at 2x uncompressed line size
+    if (iMargin > TIFF_FILE_BUF_SIZE/4) // but wide images need to fit in the buffer too
+        iMargin = TIFF_FILE_BUF_SIZE/4;
+    pBufEnd = &pPage->ucFileBuf[pPage->iVLCSize] - iMargin;
     while (rc == TIFF_SUCCESS && pPage->y < pPage->iHeight) {
         if (pPage->pBuf > pBufEnd && bHasMoreData) // we need more compressed data
             return TIFF_NEED_MORE_DATA;
 
-        rc = Decode_one_line(pPage);
+        rc = TIFFDecodeLine(pPage);
         if (rc == TIFF_SUCCESS) {
             // Draw the current line and pass to callback
             TIFFDrawLine(pPage, pPage->y, pPage->pCur); // y is incremented in here
@@ -1671,48 +3551,1102 @@ static int Decode_Inc(TIFFIMAGE *pPage, int bHasMoreData)
             pPage->pCur = t1;
         }
     } // while there's enough data and decoding succeeds
-    return rc;
+    return (rc == TIFF_END_OF_BLOCK) ? TIFF_SUCCESS : rc;
 } /* Decode_Inc() */
 //
-// Decompress the VLC data
+// The strips which hold the lines of the window [first, end); the others
+// don't need to be read or decoded
 //
-static int Decode(TIFFIMAGE *pPage)
+static void TIFFStripRange(TIFFIMAGE *pPage, int *pFirst, int *pEnd)
 {
-    int y, rc, bContinue, xsize;
-    uint8_t *pBufEnd;
-    int16_t *t1;
-    
-    xsize = pPage->iWidth; /* For performance reasons */
-    
+    int y;
+
+    y = (pPage->window.y > 0 && pPage->window.y < pPage->iHeight) ? pPage->window.y : 0;
+    *pFirst = y / pPage->iRowsPerStrip;
+    y = pPage->window.y + pPage->window.iHeight;
+    if (y <= 0 || y > pPage->iHeight)
+        y = pPage->iHeight;
+    *pEnd = (y + pPage->iRowsPerStrip - 1) / pPage->iRowsPerStrip;
+    if (*pEnd <= *pFirst)
+        *pEnd = *pFirst + 1;
+} /* TIFFStripRange() */
+//
+// Get ready to decode the given strip
+// returns the point at which the buffer needs more data, or NULL when the
+// whole strip is in memory (read or in the caller's memory)
+//
+static uint8_t * TIFFStartStrip(TIFFIMAGE *pPage, int iStrip)
+{
+    TIFFGetStrip(pPage, iStrip);
     pPage->iVLCSize = pPage->iVLCOff = 0;
     (*pPage->pfnSeek)(&pPage->TIFFFile, pPage->iStripOffset); // start of data
+#ifdef TIFF_ZERO_COPY
+    if (pPage->pfnRead == readMem && pPage->ucFillOrder != BITDIR_LSB_FIRST)
+    {
+        uint8_t *pEnd = &pPage->TIFFFile.pData[pPage->TIFFFile.iSize], *pStart;
+        int iLen;
+
+        Decode_Begin(pPage);
+        TIFFSetDataEnd(pPage, pEnd, 0);
+        pPage->pBuf = &pPage->TIFFFile.pData[(pPage->TIFFFile.iPos > 0) ? pPage->TIFFFile.iPos : 0];
+        // the first bits are loaded past any leading 0's, the same as from
+        // ucFileBuf, where the 0's at the start of the guard region are skipped too
+        iLen = (pEnd - pPage->pBuf < 128) ? (int)(pEnd - pPage->pBuf) : 128;
+        pStart = TIFFSkipZeros(pPage, pPage->pBuf, iLen);
+        if (pStart == pEnd)
+            pStart += TIFFSkipZeros(pPage, (uint8_t *)ucGuard, (128 - iLen < TIFF_GUARD_SIZE) ? 128 - iLen : TIFF_GUARD_SIZE) - ucGuard;
+        pPage->ulBits = TIFFLOADBITS(pPage, pStart);
+        pPage->ulBitOff = 0;
+        return NULL;
+    }
+#endif
+    TIFFSetStripBuffer(pPage);
     TIFFGetMoreData(pPage); // read first block of compressed data
     Decode_Begin(pPage);
-    pPage->pBuf = pPage->ucFileBuf;
-    pBufEnd = &pPage->ucFileBuf[FILE_HIGHWATER];
+    if (pPage->pVLC != pPage->ucFileBuf) // Decode_Begin() started in ucFileBuf
+        pPage->ulBits = TIFFMOTOLONG(TIFFSkipZeros(pPage, pPage->pVLC, 128));
+    pPage->pBuf = pPage->pVLC;
+    if (pPage->TIFFFile.iPos >= pPage->iReadEnd) // the whole strip was read
+        return NULL;
+    return &pPage->pVLC[(pPage->iVLCBufSize * 3) >> 2];
+} /* TIFFStartStrip() */
+#ifdef TIFF_THREADS
+//
+// Memory, mapped files and pread() read at the position kept in the TIFFFILE
+// instead of a shared file offset, so threads can read them at the same time
+// with their own copies of the TIFFFILE
+//
+static int TIFFPositional(TIFFIMAGE *pPage)
+{
+#ifdef TIFF_PREAD
+    if (pPage->pfnRead == readFile)
+        return 1;
+#endif
+    return (pPage->TIFFFile.pData != NULL);
+} /* TIFFPositional() */
+//
+// A strip for the worker threads and the flips of its lines
+//
+typedef struct tiff_strip_job_tag
+{
+    uint8_t *pData; // compressed data, followed by the guard region
+    TIFF_FLIP *pFlips; // flips of each line, one after the other
+    int *pLineStart; // where each line starts in pFlips
+    uint8_t *pLineType; // TIFF_LINE_xxx of each line
+    TIFF_OFFSET iOffset; // where the worker reads it from (bRead)
+    int iSize; // size of the compressed data
+    int bInPlace; // pData is the caller's memory (to its end, without the guard region)
+    int bRead; // the worker reads it into pData first
+    int iFlipsSize; // allocated size of pFlips
+    int iLines; // lines decoded (fewer if there was an error)
+    int iError;
+    int bDone;
+} TIFFSTRIPJOB;
+
+typedef struct tiff_pool_tag
+{
+    TIFFSTRIPJOB *pJobs;
+    int iFirst; // the first strip of the window (pJobs[0])
+    int iJobs, iNext; // strips and the next one to decode
+    int iDrawn, iAhead; // strips drawn so far and how far the workers can get ahead
+    int bStop;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond; // signaled when a strip is decoded or drawn
+} TIFFPOOL;
+//
+// Each worker has a private copy of the decoder state with its own flips
+//
+typedef struct tiff_worker_tag
+{
+    TIFFIMAGE tiff;
+    TIFFPOOL *pPool;
+    pthread_t tid;
+} TIFFWORKER;
+//
+// Decode one strip into flips (worker thread)
+// pWork is a private copy of the image state with its own flips buffers
+//
+static void TIFFDecodeStrip(TIFFIMAGE *pWork, TIFFSTRIPJOB *pJob, int iRows)
+{
+    int y, iCount, iRead, iLen = 0;
+    TIFF_FLIP *t1;
+
+    pJob->pLineStart = (int *)malloc(iRows * (sizeof(int) + 1));
+    if (pJob->pLineStart == NULL)
+    {
+        pJob->iError = TIFF_OUT_OF_MEMORY;
+        return;
+    }
+    pJob->pLineType = (uint8_t *)&pJob->pLineStart[iRows];
+    if (pJob->bRead) // each worker reads its own strips
+    {
+        (*pWork->pfnSeek)(&pWork->TIFFFile, pJob->iOffset);
+        iRead = (*pWork->pfnRead)(&pWork->TIFFFile, pJob->pData, pJob->iSize);
+        if (iRead < 0)
+            iRead = 0;
+        if (pWork->ucFillOrder == BITDIR_LSB_FIRST)
+            TIFF_MIRROR(pJob->pData, iRead);
+        memcpy_P(&pJob->pData[iRead], ucGuard, TIFF_GUARD_SIZE);
+        pJob->iSize = iRead;
+    }
+    Decode_Begin(pWork);
+    pWork->pBuf = pJob->pData;
+    TIFFSetDataEnd(pWork, &pJob->pData[pJob->iSize], !pJob->bInPlace);
+    pWork->ulBits = TIFFLOADBITS(pWork, pWork->pBuf);
+    pWork->ulBitOff = 0;
+    pWork->iError = TIFF_SUCCESS;
+    for (y=0; y<iRows; y++)
+    {
+        if (TIFFDecodeLine(pWork) != TIFF_SUCCESS)
+        {
+            pJob->iError = pWork->iError;
+            break;
+        }
+        iCount = pWork->iFlipCount;
+        if (iLen + iCount > pJob->iFlipsSize) // make room for more lines
+        {
+            TIFF_FLIP *pFlips;
+            int iSize = (pJob->iFlipsSize * 2 > iLen + iCount) ? pJob->iFlipsSize * 2 : iLen + iCount + 1024;
+            pFlips = (TIFF_FLIP *)realloc(pJob->pFlips, iSize * sizeof(TIFF_FLIP));
+            if (pFlips == NULL)
+            {
+                pJob->iError = TIFF_OUT_OF_MEMORY;
+                break;
+            }
+            pJob->pFlips = pFlips;
+            pJob->iFlipsSize = iSize;
+        }
+        memcpy(&pJob->pFlips[iLen], pWork->pCur, iCount * sizeof(TIFF_FLIP));
+        pJob->pLineStart[y] = iLen;
+        pJob->pLineType[y] = pWork->ucLineType;
+        iLen += iCount;
+        t1 = pWork->pRef; // swap current and reference lines
+        pWork->pRef = pWork->pCur;
+        pWork->pCur = t1;
+    }
+    pJob->iLines = y;
+} /* TIFFDecodeStrip() */
+
+static void * TIFFStripWorker(void *pArg)
+{
+    TIFFIMAGE *pWork = &((TIFFWORKER *)pArg)->tiff;
+    TIFFPOOL *pPool = ((TIFFWORKER *)pArg)->pPool;
+    int i, iRows;
+
+    pthread_mutex_lock(&pPool->mutex);
+    while (!pPool->bStop && pPool->iNext < pPool->iJobs)
+    {
+        if (pPool->iNext >= pPool->iDrawn + pPool->iAhead) // don't use too much memory
+        {
+            pthread_cond_wait(&pPool->cond, &pPool->mutex);
+            continue;
+        }
+        i = pPool->iNext++;
+        pthread_mutex_unlock(&pPool->mutex);
+        iRows = pWork->iHeight - (pPool->iFirst + i) * pWork->iRowsPerStrip;
+        if (iRows > pWork->iRowsPerStrip)
+            iRows = pWork->iRowsPerStrip;
+        TIFFDecodeStrip(pWork, &pPool->pJobs[i], iRows);
+        pthread_mutex_lock(&pPool->mutex);
+        pPool->pJobs[i].bDone = 1;
+        pthread_cond_broadcast(&pPool->cond);
+    }
+    pthread_mutex_unlock(&pPool->mutex);
+    return NULL;
+} /* TIFFStripWorker() */
+//
+// Decode the strips on worker threads and draw the lines in order
+// The workers read the strips themselves from positional sources; the
+// compressed data of other files is read first since their callbacks can't
+// be shared.
+// returns the error code or TIFF_NEED_MORE_DATA if the threads couldn't be
+// started (nothing was drawn, decode it on this thread instead)
+//
+static int TIFFDecodeStrips(TIFFIMAGE *pPage, int (*pfnDrawLine)(TIFFIMAGE *, int, TIFF_FLIP *))
+{
+    TIFFPOOL pool;
+    TIFFSTRIPJOB *pJobs;
+    TIFFWORKER *pWorkers;
+    TIFF_FLIP *pFlips;
+    uint8_t *pData, *d;
+    int64_t llTotal;
+    TIFF_OFFSET iOffset, iLen;
+    int i, y, iLine, iFirst, iStrips, iThreads, iStarted, iFlips, bContinue, rc, bInPlace, bPositional;
+
+#ifdef TIFF_ZERO_COPY
+    bInPlace = (pPage->pfnRead == readMem && pPage->ucFillOrder != BITDIR_LSB_FIRST);
+#else
+    bInPlace = 0;
+#endif
+    bPositional = TIFFPositional(pPage);
+    TIFFStripRange(pPage, &iFirst, &iStrips); // only read the strips of the window
+    iStrips -= iFirst;
+    iThreads = (pPage->iThreads < iStrips) ? pPage->iThreads : iStrips;
+    pJobs = (TIFFSTRIPJOB *)calloc(iStrips, sizeof(TIFFSTRIPJOB));
+    if (pJobs == NULL)
+        return TIFF_NEED_MORE_DATA;
+    // find the size of all of the compressed data
+    llTotal = 0;
+    for (i=0; i<iStrips; i++)
+    {
+        TIFFGetStrip(pPage, iFirst + i);
+        if (pPage->iStripOffset < 0 || pPage->iStripOffset >= pPage->TIFFFile.iSize || pPage->iStripSize < 0)
+            pPage->iStripSize = 0; // corrupt, decode the guard region instead
+        else if (pPage->iStripSize > pPage->TIFFFile.iSize - pPage->iStripOffset)
+            pPage->iStripSize = pPage->TIFFFile.iSize - pPage->iStripOffset;
+        pJobs[i].iSize = pPage->iStripSize;
+        llTotal += pPage->iStripSize + TIFF_GUARD_SIZE;
+    }
+    pData = NULL; // strips in the caller's memory are decoded where they are
+    if (!bInPlace && llTotal < 0x40000000)
+        pData = (uint8_t *)malloc((size_t)llTotal);
+    iFlips = TIFF_FLIPS_PER_LINE(pPage->iWidth);
+    pWorkers = (TIFFWORKER *)malloc(iThreads * (sizeof(TIFFWORKER) + 2 * iFlips * sizeof(TIFF_FLIP)));
+    if ((pData == NULL && !bInPlace) || pWorkers == NULL)
+    {
+        free(pData);
+        free(pWorkers);
+        free(pJobs);
+        return TIFF_NEED_MORE_DATA;
+    }
+    d = pData;
+    for (i=0; i<iStrips; i++)
+    {
+        TIFFGetStrip(pPage, iFirst + i);
+        if (bInPlace) // read through to the end of the memory like DecodeLines()
+        {
+            iOffset = (pJobs[i].iSize) ? pPage->iStripOffset : pPage->TIFFFile.iSize;
+            iLen = pPage->TIFFFile.iSize - iOffset;
+            if (iLen > 0x7fffffff - TIFF_GUARD_SIZE) // mapped files can be larger than 2GB
+                iLen = 0x7fffffff - TIFF_GUARD_SIZE;
+            pJobs[i].pData = &pPage->TIFFFile.pData[iOffset];
+            pJobs[i].iSize = (int)iLen;
+            pJobs[i].bInPlace = 1;
+            continue;
+        }
+        if (bPositional && pJobs[i].iSize) // the worker reads it
+        {
+            pJobs[i].pData = d;
+            pJobs[i].iOffset = pPage->iStripOffset;
+            pJobs[i].bRead = 1;
+            d += pJobs[i].iSize + TIFF_GUARD_SIZE;
+            continue;
+        }
+        (*pPage->pfnSeek)(&pPage->TIFFFile, pPage->iStripOffset);
+        y = 0;
+        if (pJobs[i].iSize)
+            y = (*pPage->pfnRead)(&pPage->TIFFFile, d, pJobs[i].iSize);
+        if (y < 0)
+            y = 0;
+        if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
+            TIFF_MIRROR(d, y);
+        memcpy_P(&d[y], ucGuard, TIFF_GUARD_SIZE);
+        pJobs[i].pData = d;
+        pJobs[i].iSize = y;
+        d += y + TIFF_GUARD_SIZE;
+    }
+    memset(&pool, 0, sizeof(pool));
+    pool.pJobs = pJobs;
+    pool.iFirst = iFirst;
+    pool.iJobs = iStrips;
+    pool.iAhead = iThreads * 2;
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.cond, NULL);
+    pFlips = (TIFF_FLIP *)&pWorkers[iThreads];
+    for (iStarted=0; iStarted<iThreads; iStarted++)
+    {
+        memcpy(&pWorkers[iStarted].tiff, pPage, sizeof(TIFFIMAGE));
+        pWorkers[iStarted].tiff.CurFlips = &pFlips[iStarted * 2 * iFlips];
+        pWorkers[iStarted].tiff.RefFlips = &pFlips[(iStarted * 2 + 1) * iFlips];
+        pWorkers[iStarted].pPool = &pool;
+        if (pthread_create(&pWorkers[iStarted].tid, NULL, TIFFStripWorker, &pWorkers[iStarted]) != 0)
+            break;
+    }
+    rc = TIFF_NEED_MORE_DATA;
+    if (iStarted) // draw the lines in order as the strips are ready
+    {
+        rc = TIFF_SUCCESS;
+        bContinue = 1;
+        y = iFirst * pPage->iRowsPerStrip;
+        for (i=0; i<iStrips && bContinue && rc == TIFF_SUCCESS; i++)
+        {
+            pthread_mutex_lock(&pool.mutex);
+            while (!pJobs[i].bDone)
+                pthread_cond_wait(&pool.cond, &pool.mutex);
+            pthread_mutex_unlock(&pool.mutex);
+            for (iLine=0; iLine<pJobs[i].iLines && bContinue; iLine++)
+            {
+                pPage->ucLineType = pJobs[i].pLineType[iLine];
+                bContinue = (*pfnDrawLine)(pPage, y++, &pJobs[i].pFlips[pJobs[i].pLineStart[iLine]]);
+            }
+            rc = pJobs[i].iError; // stop at the first bad strip
+            free(pJobs[i].pFlips);
+            free(pJobs[i].pLineStart);
+            pJobs[i].pFlips = NULL;
+            pJobs[i].pLineStart = NULL;
+            pthread_mutex_lock(&pool.mutex);
+            pool.iDrawn = i+1;
+            pthread_cond_broadcast(&pool.cond);
+            pthread_mutex_unlock(&pool.mutex);
+        }
+    }
+    pthread_mutex_lock(&pool.mutex);
+    pool.bStop = 1;
+    pthread_cond_broadcast(&pool.cond);
+    pthread_mutex_unlock(&pool.mutex);
+    for (i=0; i<iStarted; i++)
+        pthread_join(pWorkers[i].tid, NULL);
+    for (i=0; i<iStrips; i++)
+    {
+        free(pJobs[i].pFlips);
+        free(pJobs[i].pLineStart);
+    }
+    pthread_mutex_destroy(&pool.mutex);
+    pthread_cond_destroy(&pool.cond);
+    free(pWorkers);
+    free(pData);
+    free(pJobs);
+    if (rc != TIFF_NEED_MORE_DATA)
+        pPage->iError = rc;
+    return rc;
+} /* TIFFDecodeStrips() */
+//
+// Compressed data read ahead by a background thread
+// Each chunk has room in front of it for the end of the previous one, which
+// the decoder hadn't used yet when it moved on to the next chunk
+//
+#define TIFF_RA_HEADROOM (TIFF_FILE_BUF_SIZE / 4)
+typedef struct tiff_read_slot_tag
+{
+    uint8_t *pData; // the chunk, TIFF_RA_HEADROOM bytes into its buffer
+    int iSize; // bytes read
+    int iStrip; // which strip of the window it belongs to (0 = iFirst)
+    int bLast; // the last chunk of the strip
+    int bFull; // read and not used up yet
+} TIFFREADSLOT;
+
+typedef struct tiff_read_ahead_tag
+{
+    TIFFIMAGE *pPage;
+    TIFFREADSLOT slots[TIFF_MAX_READ_AHEAD];
+    TIFF_OFFSET *pStrips; // start and end of each strip of the window
+    uint8_t *pMem; // the chunk buffers
+    int iFirst, iStrips; // the strips of the window
+    int iSlots, iChunk;
+    int iRead, iUsed; // chunks read and taken by the decoder so far
+    int bStop;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond; // signaled when a chunk is read or used up
+    pthread_t tid;
+} TIFFREADAHEAD;
+
+static int TIFFReadAheadBuffers(int iBuffers)
+{
+    if (iBuffers <= 0) return 0;
+    if (iBuffers < 2) return 2; // one is read while the other is decoded
+    return (iBuffers > TIFF_MAX_READ_AHEAD) ? TIFF_MAX_READ_AHEAD : iBuffers;
+} /* TIFFReadAheadBuffers() */
+//
+// Read the strips of the window in order (background thread)
+// The decoder doesn't use the file while it runs
+//
+static void * TIFFReadAheadThread(void *pArg)
+{
+    TIFFREADAHEAD *pRA = (TIFFREADAHEAD *)pArg;
+    TIFFIMAGE *pPage = pRA->pPage;
+    TIFFREADSLOT *pSlot;
+    TIFF_OFFSET iPos, iEnd;
+    int i, iLen, bLast, bStop;
+
+    for (i=0; i<pRA->iStrips; i++)
+    {
+        iPos = pRA->pStrips[i*2];
+        iEnd = pRA->pStrips[i*2+1];
+        (*pPage->pfnSeek)(&pPage->TIFFFile, iPos);
+        do {
+            pthread_mutex_lock(&pRA->mutex);
+            pSlot = &pRA->slots[pRA->iRead % pRA->iSlots];
+            while (pSlot->bFull && !pRA->bStop)
+                pthread_cond_wait(&pRA->cond, &pRA->mutex);
+            bStop = pRA->bStop;
+            pthread_mutex_unlock(&pRA->mutex);
+            if (bStop)
+                return NULL;
+            iLen = (iEnd - iPos < pRA->iChunk) ? (int)(iEnd - iPos) : pRA->iChunk;
+            iLen = (*pPage->pfnRead)(&pPage->TIFFFile, pSlot->pData, iLen);
+            if (iLen < 0)
+                iLen = 0;
+            if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
+                TIFF_MIRROR(pSlot->pData, iLen);
+            memcpy_P(&pSlot->pData[iLen], ucGuard, TIFF_GUARD_SIZE);
+            iPos += iLen;
+            bLast = (iLen == 0 || iPos >= iEnd);
+            pthread_mutex_lock(&pRA->mutex);
+            pSlot->iSize = iLen;
+            pSlot->iStrip = i;
+            pSlot->bLast = bLast;
+            pSlot->bFull = 1;
+            pRA->iRead++;
+            pthread_cond_broadcast(&pRA->cond);
+            pthread_mutex_unlock(&pRA->mutex);
+        } while (!bLast);
+    }
+    return NULL;
+} /* TIFFReadAheadThread() */
+//
+// Get iCount values of a strip array with one read of the file
+// (TIFFArrayValue() reads them one at a time)
+//
+#define TIFF_RA_BATCH 32
+static void TIFFArrayValues(TIFFIMAGE *pPage, TIFFTAGARRAY *pArray, int iIndex, int iCount, uint64_t *pValues)
+{
+    uint8_t ucTemp[TIFF_RA_BATCH * 8];
+    int i, iLen, iSize = (pArray->ucType == 3) ? 2 : (pArray->ucType == 16) ? 8 : 4;
+    int iInline = pPage->ucBigTIFF ? 8 : 4;
+    TIFF_OFFSET iOffset;
+
+    if (pPage->iStripCount <= iInline / iSize) // in the tag
+    {
+        for (i=0; i<iCount; i++)
+            pValues[i] = TIFFArrayValue(pPage, pArray, iIndex + i);
+        return;
+    }
+    if (pPage->ucBigTIFF)
+        iOffset = TIFFOffset(TIFFLONG64(pArray->ucValue, pPage->ucMotorola));
+    else
+        iOffset = TIFFOffset(TIFFLONG(pArray->ucValue, pPage->ucMotorola));
+    iLen = 0;
+    if (iOffset >= 0 && iOffset + (TIFF_OFFSET)iIndex * iSize < pPage->TIFFFile.iSize)
+    {
+        (*pPage->pfnSeek)(&pPage->TIFFFile, iOffset + (TIFF_OFFSET)iIndex * iSize);
+        iLen = (*pPage->pfnRead)(&pPage->TIFFFile, ucTemp, iCount * iSize);
+    }
+    for (i=0; i<iCount; i++)
+    {
+        if ((i+1) * iSize > iLen) // past the end of the file
+            pValues[i] = 0;
+        else if (iSize == 2)
+            pValues[i] = TIFFSHORT(&ucTemp[i*2], pPage->ucMotorola);
+        else if (iSize == 4)
+            pValues[i] = TIFFLONG(&ucTemp[i*4], pPage->ucMotorola);
+        else
+            pValues[i] = TIFFLONG64(&ucTemp[i*8], pPage->ucMotorola);
+    }
+} /* TIFFArrayValues() */
+//
+// Start reading the strips iFirst to iEnd-1 ahead of the decoder
+// returns NULL if they're read as they're needed instead (the data is in
+// memory, a strip's size isn't known or the thread couldn't be started)
+//
+static TIFFREADAHEAD * TIFFStartReadAhead(TIFFIMAGE *pPage, int iFirst, int iEnd)
+{
+    TIFFREADAHEAD *pRA;
+    uint64_t u64Offsets[TIFF_RA_BATCH], u64Sizes[TIFF_RA_BATCH], u64Size;
+    TIFF_OFFSET iOffset;
+    int i, j, iMaxSize = 0;
+
+#ifdef TIFF_ZERO_COPY
+    if (pPage->pfnRead == readMem && pPage->ucFillOrder != BITDIR_LSB_FIRST)
+        return NULL; // decoded where it is
+#endif
+    if (!pPage->StripSizes.ucType || iEnd <= iFirst)
+        return NULL;
+    pRA = (TIFFREADAHEAD *)calloc(1, sizeof(TIFFREADAHEAD));
+    if (pRA == NULL)
+        return NULL;
+    pRA->pStrips = (TIFF_OFFSET *)malloc((iEnd - iFirst) * 2 * sizeof(TIFF_OFFSET));
+    if (pRA->pStrips == NULL)
+    {
+        free(pRA);
+        return NULL;
+    }
+    // the strip offsets can be in the file, which belongs to the thread later
+    for (i=0; i<iEnd-iFirst; i++)
+    {
+        if ((i & (TIFF_RA_BATCH-1)) == 0)
+        {
+            j = (iEnd - iFirst - i < TIFF_RA_BATCH) ? iEnd - iFirst - i : TIFF_RA_BATCH;
+            TIFFArrayValues(pPage, &pPage->StripOffsets, iFirst + i, j, u64Offsets);
+            TIFFArrayValues(pPage, &pPage->StripSizes, iFirst + i, j, u64Sizes);
+        }
+        iOffset = TIFFOffset(u64Offsets[i & (TIFF_RA_BATCH-1)]);
+        u64Size = u64Sizes[i & (TIFF_RA_BATCH-1)];
+        if (u64Size == 0 || iOffset < 0 || iOffset >= pPage->TIFFFile.iSize || u64Size > (uint64_t)(pPage->TIFFFile.iSize - iOffset))
+            break; // DecodeLines() reads to the end of the file
+        pRA->pStrips[i*2] = iOffset;
+        pRA->pStrips[i*2+1] = iOffset + (TIFF_OFFSET)u64Size;
+        if ((int)u64Size > iMaxSize)
+            iMaxSize = (int)u64Size;
+    }
+    pRA->iFirst = iFirst;
+    pRA->iStrips = iEnd - iFirst;
+    pRA->iSlots = pPage->iReadAhead;
+    pRA->iChunk = (iMaxSize < TIFF_READ_AHEAD_CHUNK) ? iMaxSize : TIFF_READ_AHEAD_CHUNK;
+    if (i == pRA->iStrips)
+        pRA->pMem = (uint8_t *)malloc((size_t)pRA->iSlots * (TIFF_RA_HEADROOM + pRA->iChunk + TIFF_GUARD_SIZE));
+    if (pRA->pMem == NULL)
+    {
+        free(pRA->pStrips);
+        free(pRA);
+        return NULL;
+    }
+    for (i=0; i<pRA->iSlots; i++)
+        pRA->slots[i].pData = &pRA->pMem[i * (TIFF_RA_HEADROOM + pRA->iChunk + TIFF_GUARD_SIZE) + TIFF_RA_HEADROOM];
+    pRA->pPage = pPage;
+    pthread_mutex_init(&pRA->mutex, NULL);
+    pthread_cond_init(&pRA->cond, NULL);
+    if (pthread_create(&pRA->tid, NULL, TIFFReadAheadThread, pRA) != 0)
+    {
+        pthread_mutex_destroy(&pRA->mutex);
+        pthread_cond_destroy(&pRA->cond);
+        free(pRA->pMem);
+        free(pRA->pStrips);
+        free(pRA);
+        return NULL;
+    }
+    return pRA;
+} /* TIFFStartReadAhead() */
+//
+// Move on to the next chunk read ahead; the iTail bytes which weren't used
+// yet at the end of the current one are copied in front of it
+// returns the chunk's slot
+//
+static TIFFREADSLOT * TIFFReadAheadNext(TIFFREADAHEAD *pRA, int iTail)
+{
+    TIFFIMAGE *pPage = pRA->pPage;
+    TIFFREADSLOT *pSlot, *pPrev = NULL;
+
+    pthread_mutex_lock(&pRA->mutex);
+    if (pRA->iUsed)
+        pPrev = &pRA->slots[(pRA->iUsed - 1) % pRA->iSlots];
+    pSlot = &pRA->slots[pRA->iUsed % pRA->iSlots];
+    while (!pSlot->bFull)
+        pthread_cond_wait(&pRA->cond, &pRA->mutex);
+    pthread_mutex_unlock(&pRA->mutex);
+    if (iTail > 0)
+        memcpy(pSlot->pData - iTail, pPage->pBuf, iTail);
+    pthread_mutex_lock(&pRA->mutex);
+    if (pPrev)
+        pPrev->bFull = 0; // the thread can read into it again
+    pRA->iUsed++;
+    pthread_cond_broadcast(&pRA->cond);
+    pthread_mutex_unlock(&pRA->mutex);
+    pPage->pVLC = pSlot->pData - iTail;
+    pPage->iVLCSize = iTail + pSlot->iSize;
+    pPage->iVLCOff = 0;
+    TIFFSetDataEnd(pPage, &pPage->pVLC[pPage->iVLCSize], 1);
+    pPage->pBuf = pPage->pVLC;
+    return pSlot;
+} /* TIFFReadAheadNext() */
+//
+// Get ready to decode the next strip from the chunks read ahead
+// returns the point at which the decoder needs the next chunk, or NULL
+// if it has the whole strip
+//
+static uint8_t * TIFFReadAheadStrip(TIFFREADAHEAD *pRA, int iStrip)
+{
+    TIFFIMAGE *pPage = pRA->pPage;
+    TIFFREADSLOT *pSlot;
+
+    do { // skip what's left of the previous strip
+        pSlot = TIFFReadAheadNext(pRA, 0);
+    } while (pSlot->iStrip < iStrip - pRA->iFirst);
+    Decode_Begin(pPage);
+    pPage->ulBits = TIFFMOTOLONG(TIFFSkipZeros(pPage, pPage->pVLC, 128)); // Decode_Begin() started in ucFileBuf
+    pPage->pBuf = pPage->pVLC;
+    return (pSlot->bLast) ? NULL : &pPage->pVLC[pPage->iVLCSize - TIFF_RA_HEADROOM];
+} /* TIFFReadAheadStrip() */
+//
+// Refill from the next chunk of the strip
+//
+static uint8_t * TIFFReadAheadMore(TIFFREADAHEAD *pRA)
+{
+    TIFFIMAGE *pPage = pRA->pPage;
+    TIFFREADSLOT *pSlot;
+    int iTail;
+
+    iTail = (int)(&pPage->pVLC[pPage->iVLCSize] - pPage->pBuf);
+    if (iTail < 0) // the decoder went into the guard region
+    {
+        pPage->pBuf = &pPage->pVLC[pPage->iVLCSize];
+        iTail = 0;
+    }
+    pSlot = TIFFReadAheadNext(pRA, iTail);
+    return (pSlot->bLast) ? NULL : &pPage->pVLC[pPage->iVLCSize - TIFF_RA_HEADROOM];
+} /* TIFFReadAheadMore() */
+
+static void TIFFStopReadAhead(TIFFREADAHEAD *pRA)
+{
+    pthread_mutex_lock(&pRA->mutex);
+    pRA->bStop = 1;
+    pthread_cond_broadcast(&pRA->cond);
+    pthread_mutex_unlock(&pRA->mutex);
+    pthread_join(pRA->tid, NULL);
+    pthread_mutex_destroy(&pRA->mutex);
+    pthread_cond_destroy(&pRA->cond);
+    free(pRA->pMem);
+    free(pRA->pStrips);
+    free(pRA);
+} /* TIFFStopReadAhead() */
+#endif // TIFF_THREADS
+#ifdef TIFF_TILES
+//
+// The decoder state of one column of tiles
+//
+typedef struct tiff_tile_col_tag
+{
+    BIGUINT ulBits;
+    uint32_t ulBitOff;
+    uint8_t *pBuf;
+    uint8_t *pData; // compressed data of the current tile, followed by the guard region
+    uint8_t *pDataEnd; // where the guard region starts
+    int iDataSize; // allocated size of pData
+    TIFF_FLIP *pCur, *pRef;
+    int iFlipCount;
+} TIFFTILECOL;
+//
+// Read a tile and get ready to decode it
+// returns 0 if there wasn't enough memory
+//
+static int TIFFStartTile(TIFFIMAGE *pPage, TIFFIMAGE *pWork, TIFFTILECOL *pCol, int iTile)
+{
+    int iSize, iRead = 0;
+
+    TIFFGetStrip(pPage, iTile);
+    iSize = pPage->iStripSize;
+    if (pPage->iStripOffset < 0 || pPage->iStripOffset >= pPage->TIFFFile.iSize || iSize < 0)
+        iSize = 0; // corrupt, decode the guard region instead
+    else if (iSize > pPage->TIFFFile.iSize - pPage->iStripOffset)
+        iSize = pPage->TIFFFile.iSize - pPage->iStripOffset;
+    if (iSize + TIFF_GUARD_SIZE > pCol->iDataSize)
+    {
+        uint8_t *pData = (uint8_t *)realloc(pCol->pData, iSize + TIFF_GUARD_SIZE);
+        if (pData == NULL)
+            return 0;
+        pCol->pData = pData;
+        pCol->iDataSize = iSize + TIFF_GUARD_SIZE;
+    }
+    if (iSize)
+    {
+        (*pPage->pfnSeek)(&pPage->TIFFFile, pPage->iStripOffset);
+        iRead = (*pPage->pfnRead)(&pPage->TIFFFile, pCol->pData, iSize);
+        if (iRead < 0)
+            iRead = 0;
+    }
+    if (pPage->ucFillOrder == BITDIR_LSB_FIRST)
+        TIFF_MIRROR(pCol->pData, iRead);
+    memcpy_P(&pCol->pData[iRead], ucGuard, TIFF_GUARD_SIZE);
+    pCol->pDataEnd = &pCol->pData[iRead];
+    Decode_Begin(pWork); // reset the flips of this column
+    pCol->pCur = pWork->pCur;
+    pCol->pRef = pWork->pRef;
+    pCol->iFlipCount = 0;
+    pCol->pBuf = pCol->pData;
+    pCol->ulBits = TIFFMOTOLONG(pCol->pBuf);
+    pCol->ulBitOff = 0;
+    return 1;
+} /* TIFFStartTile() */
+//
+// Decode a tiled image
+// Only the columns of tiles which overlap the window are read. Their lines are
+// decoded side by side and the black runs are joined into a line of flips for
+// the whole image width, so pfnDrawLine works the same as for strips.
+//
+static int TIFFDecodeTiles(TIFFIMAGE *pPage, int (*pfnDrawLine)(TIFFIMAGE *, int, TIFF_FLIP *))
+{
+    TIFFIMAGE *pWork;
+    TIFFTILECOL *pCols, *pCol;
+    TIFF_FLIP *pFlips, *pOut, *pPrev, *pTileFlips, *d, *t1;
+    int iTileWidth, iTileHeight, iAcross, iCol0, iCols, iFlips, iCount, iPrevCount;
+    int x, y, yEnd, c, i, a, b, iLast, bContinue;
+
+    iTileWidth = pPage->iTileWidth;
+    iTileHeight = pPage->iTileHeight;
+    iAcross = (pPage->iWidth + iTileWidth - 1) / iTileWidth;
+    // the columns of tiles under the window
+    x = pPage->window.x;
+    if (x < 0) x = 0;
+    if (x >= pPage->iWidth) x = pPage->iWidth-1;
+    iCol0 = x / iTileWidth;
+    x = pPage->window.x + pPage->window.iWidth - 1;
+    if (x >= pPage->iWidth) x = pPage->iWidth-1;
+    if (x < iCol0 * iTileWidth) x = iCol0 * iTileWidth;
+    iCols = (x / iTileWidth) - iCol0 + 1;
+    iFlips = TIFF_FLIPS_PER_LINE(iTileWidth);
+    pWork = (TIFFIMAGE *)malloc(sizeof(TIFFIMAGE));
+    pCols = (TIFFTILECOL *)calloc(1, iCols * (sizeof(TIFFTILECOL) + 2 * iFlips * sizeof(TIFF_FLIP)));
+    if (pWork == NULL || pCols == NULL)
+    {
+        free(pWork);
+        free(pCols);
+        pPage->iError = TIFF_OUT_OF_MEMORY;
+        return TIFF_OUT_OF_MEMORY;
+    }
+    pFlips = (TIFF_FLIP *)&pCols[iCols];
+    memcpy(pWork, pPage, sizeof(TIFFIMAGE));
+    pWork->iWidth = iTileWidth; // the tiles are decoded on their own
+    pOut = pPage->CurFlips; // the joined lines
+    pPrev = pPage->RefFlips;
+    iPrevCount = -1;
+    bContinue = 1;
+    // start at the row of tiles with the first line of the window
+    y = (pPage->window.y > 0 && pPage->window.y < pPage->iHeight) ? pPage->window.y : 0;
+    y -= y % iTileHeight;
+    while (y < pPage->iHeight && bContinue)
+    {
+        for (c=0; c<iCols; c++)
+        {
+            pWork->CurFlips = &pFlips[c * 2 * iFlips];
+            pWork->RefFlips = &pWork->CurFlips[iFlips];
+            if (!TIFFStartTile(pPage, pWork, &pCols[c], (y / iTileHeight) * iAcross + iCol0 + c))
+            {
+                pPage->iError = TIFF_OUT_OF_MEMORY;
+                bContinue = 0;
+                break;
+            }
+        }
+        yEnd = y + iTileHeight;
+        if (yEnd > pPage->iHeight)
+            yEnd = pPage->iHeight;
+        for (; y < yEnd && bContinue; y++)
+        {
+            d = pOut;
+            iLast = 0;
+            for (c=0; c<iCols; c++)
+            {
+                pCol = &pCols[c];
+                pWork->pBuf = pCol->pBuf;
+                TIFFSetDataEnd(pWork, pCol->pDataEnd, 1);
+                pWork->ulBits = pCol->ulBits;
+                pWork->ulBitOff = pCol->ulBitOff;
+                pWork->pCur = pCol->pCur;
+                pWork->pRef = pCol->pRef;
+                pWork->iFlipCount = pCol->iFlipCount;
+                if (TIFFDecodeLine(pWork) != TIFF_SUCCESS)
+                {
+                    pPage->iError = pWork->iError;
+                    bContinue = 0;
+                    break;
+                }
+                // add its black runs to the line, joining the ones which touch
+                x = (iCol0 + c) * iTileWidth;
+                pTileFlips = pWork->pCur;
+                for (i=0; i+1 < pWork->iFlipCount && pTileFlips[i] < iTileWidth; i += 2)
+                {
+                    a = x + pTileFlips[i];
+                    b = x + ((pTileFlips[i+1] < iTileWidth) ? pTileFlips[i+1] : iTileWidth);
+                    if (b > pPage->iWidth) // the right column of tiles is padded
+                        b = pPage->iWidth;
+                    if (a < iLast)
+                        a = iLast;
+                    if (a >= b)
+                        continue;
+                    if (a == iLast && d != pOut)
+                        d[-1] = b;
+                    else
+                    {
+                        *d++ = a;
+                        *d++ = b;
+                    }
+                    iLast = b;
+                }
+                pCol->pBuf = pWork->pBuf;
+                pCol->ulBits = pWork->ulBits;
+                pCol->ulBitOff = pWork->ulBitOff;
+                pCol->pCur = pWork->pRef; // swap current and reference lines
+                pCol->pRef = pWork->pCur;
+                pCol->iFlipCount = pWork->iFlipCount;
+            }
+            if (!bContinue)
+                break;
+            iCount = (int)(d - pOut);
+            *d++ = pPage->iWidth; // terminate the line
+            *d++ = pPage->iWidth;
+            if (iCount == 0)
+                pPage->ucLineType = TIFF_LINE_WHITE;
+            else if (iCount == iPrevCount && memcmp(pOut, pPrev, iCount * sizeof(TIFF_FLIP)) == 0)
+                pPage->ucLineType = TIFF_LINE_SAME;
+            else
+                pPage->ucLineType = TIFF_LINE_NEW;
+            bContinue = (*pfnDrawLine)(pPage, y, pOut);
+            t1 = pPrev;
+            pPrev = pOut;
+            pOut = t1;
+            iPrevCount = iCount;
+        }
+    }
+    for (c=0; c<iCols; c++)
+        free(pCols[c].pData);
+    free(pCols);
+    free(pWork);
+    return pPage->iError;
+} /* TIFFDecodeTiles() */
+#endif // TIFF_TILES
+//
+// Decompress the VLC data and draw each line with pfnDrawLine
+// (inlined so that the C++ specialized decoders get a direct call)
+//
+static TIFF_ALWAYS_INLINE int DecodeLines(TIFFIMAGE *pPage, int (*pfnDrawLine)(TIFFIMAGE *, int, TIFF_FLIP *))
+{
+    int y, yEnd, rc, bContinue, iStrip, iStripEnd, iEndStrip;
+    uint8_t *pBufEnd;
+    TIFF_FLIP *t1;
+#ifdef TIFF_THREADS
+    TIFFREADAHEAD *pRA = NULL;
+#endif
+    
+    if (!TIFFAllocBuffers(pPage))
+        return pPage->iError;
+#ifdef TIFF_TILES
+    if (pPage->iTileWidth)
+        return TIFFDecodeTiles(pPage, pfnDrawLine);
+#endif
+#ifdef TIFF_THREADS
+    if (pPage->iThreads > 0 && pPage->iStripCount > 1 && pPage->StripSizes.ucType)
+    {
+        rc = TIFFDecodeStrips(pPage, pfnDrawLine);
+        if (rc != TIFF_NEED_MORE_DATA) // otherwise the threads couldn't be started
+            return rc;
+    }
+#endif
+    pBufEnd = NULL;
+    if (pPage->iRowsPerStrip <= 0)
+        return pPage->iError; // nothing to decode
+    // start at the strip with the first line of the window and stop after
+    // the one with its last line
+    TIFFStripRange(pPage, &iStrip, &iEndStrip);
+    y = iStripEnd = iStrip * pPage->iRowsPerStrip;
+    yEnd = iEndStrip * pPage->iRowsPerStrip;
+    if (yEnd > pPage->iHeight)
+        yEnd = pPage->iHeight;
+#ifdef TIFF_THREADS
+    if (pPage->iReadAhead)
+        pRA = TIFFStartReadAhead(pPage, iStrip, iEndStrip);
+#endif
     
    bContinue = 1;
    /* Decode the image */
-   for (y=0; y < pPage->iHeight && bContinue; y++)
+   for (; y < yEnd && bContinue; y++)
       {
 //g4_restart:
 //      iCur = iRef = 0; /* Point to start of current and reference line */
-      if (pPage->pBuf >= pBufEnd) // time to read more data
+      if (y == iStripEnd) // each strip is coded on its own
+      {
+#ifdef TIFF_THREADS
+          if (pRA)
+              pBufEnd = TIFFReadAheadStrip(pRA, iStrip++);
+          else
+#endif
+          pBufEnd = TIFFStartStrip(pPage, iStrip++);
+          iStripEnd += pPage->iRowsPerStrip;
+      }
+      if (pBufEnd && pPage->pBuf >= pBufEnd) // time to read more data
       {
-          pPage->iVLCOff = (int)(pPage->pBuf - pPage->ucFileBuf);
+#ifdef TIFF_THREADS
+          if (pRA)
+              pBufEnd = TIFFReadAheadMore(pRA);
+          else
+#endif
+          {
+          pPage->iVLCOff = (int)(pPage->pBuf - pPage->pVLC);
           TIFFGetMoreData(pPage);
-          pPage->pBuf = pPage->ucFileBuf;
+          pPage->pBuf = pPage->pVLC;
+          }
       }
-      rc = Decode_one_line(pPage);
+      rc = TIFFDecodeLine(pPage);
+      if (rc != TIFF_SUCCESS) // corrupt or truncated data
+          break;
 
       // Draw the current line
-      bContinue = TIFFDrawLine(pPage, y, pPage->pCur);
+      bContinue = (*pfnDrawLine)(pPage, y, pPage->pCur);
       /*--- Swap current and reference lines ---*/
       t1 = pPage->pRef;
       pPage->pRef = pPage->pCur;
       pPage->pCur = t1;
       } /* for */
+#ifdef TIFF_THREADS
+   if (pRA)
+       TIFFStopReadAhead(pRA);
+#endif
    return pPage->iError;
+} /* DecodeLines() */
+
+static int Decode(TIFFIMAGE *pPage)
+{
+    return DecodeLines(pPage, TIFFDrawLine);
 } /* Decode() */
+#ifdef TIFF_THREADS
+//
+// The pages of a document shared by the batch decode threads
+//
+typedef struct tiff_page_pool_tag
+{
+    TIFFIMAGE *pPage;
+    TIFF_READ_CALLBACK *pfnRead; // the caller's file callbacks
+    TIFF_SEEK_CALLBACK *pfnSeek;
+    int iNext, iPages; // next page to decode and the number of pages
+    int iErrorPage, iError; // the first page which failed and why
+    pthread_mutex_t mutex; // protects the above and the file
+} TIFFPAGEPOOL;
+
+typedef struct tiff_page_worker_tag
+{
+    TIFFIMAGE tiff;
+    TIFFPAGEPOOL *pPool;
+    pthread_t tid;
+} TIFFPAGEWORKER;
+//
+// The threads share the file handle, so each read seeks to the thread's
+// own position first and the pair is done with the pool locked
+//
+static int32_t TIFFLockedRead(TIFFFILE *pFile, uint8_t *pBuf, int32_t iLen)
+{
+    TIFFPAGEPOOL *pPool = (TIFFPAGEPOOL *)pFile->pPool;
+    int32_t iBytesRead;
+
+    pthread_mutex_lock(&pPool->mutex);
+    (*pPool->pfnSeek)(pFile, pFile->iPos);
+    iBytesRead = (*pPool->pfnRead)(pFile, pBuf, iLen);
+    pthread_mutex_unlock(&pPool->mutex);
+    return iBytesRead;
+} /* TIFFLockedRead() */
+
+static TIFF_OFFSET TIFFLockedSeek(TIFFFILE *pFile, TIFF_OFFSET iPosition)
+{
+    if (iPosition < 0) iPosition = 0;
+    else if (iPosition >= pFile->iSize) iPosition = pFile->iSize-1;
+    pFile->iPos = iPosition;
+    return iPosition;
+} /* TIFFLockedSeek() */
+
+static void * TIFFPageWorker(void *pArg)
+{
+    TIFFPAGEWORKER *pWorker = (TIFFPAGEWORKER *)pArg;
+    TIFFPAGEPOOL *pPool = pWorker->pPool;
+    TIFFIMAGE *pWork = &pWorker->tiff;
+    TIFFWINDOW *pWindow = &pPool->pPage->window;
+    uint8_t *p4BPP = NULL;
+    int iPage, rc, iSize, i4BPPSize = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pPool->mutex);
+        iPage = pPool->iNext++;
+        pthread_mutex_unlock(&pPool->mutex);
+        if (iPage >= pPool->iPages)
+            break;
+        rc = TIFF_SUCCESS;
+        if (!TIFFOpenPage(pWork, iPage))
+            rc = pWork->iError;
+        if (rc == TIFF_SUCCESS)
+        {
+            // each page is drawn whole with the caller's pixel type and scale
+            pWork->window.ucPixelType = pWindow->ucPixelType;
+            pWork->window.iScale = pWindow->iScale;
+            pWork->window.iScaleY = pWindow->iScaleY;
+            pWork->window.dstx = pWindow->dstx;
+            pWork->window.dsty = pWindow->dsty;
+            if (pWindow->ucPixelType == TIFF_PIXEL_4BPP) // each thread needs its own 4-bpp line
+            {
+                iSize = TIFFScale(pWork->window.iWidth, pWindow->iScale); // iScaledWidth
+                iSize = GRAY_BYTES(iSize*2) * 2; // what Scale2Gray4BPP() writes
+                if (iSize > i4BPPSize)
+                {
+                    free(p4BPP);
+                    p4BPP = (uint8_t *)malloc(iSize);
+                    i4BPPSize = (p4BPP) ? iSize : 0;
+                }
+                pWork->window.p4BPP = p4BPP;
+                if (p4BPP == NULL)
+                    rc = TIFF_OUT_OF_MEMORY;
+            }
+        }
+        if (rc == TIFF_SUCCESS)
+            rc = Decode(pWork);
+        if (rc != TIFF_SUCCESS)
+        {
+            pthread_mutex_lock(&pPool->mutex);
+            if (pPool->iError == TIFF_SUCCESS || iPage < pPool->iErrorPage)
+            {
+                pPool->iError = rc;
+                pPool->iErrorPage = iPage;
+            }
+            pthread_mutex_unlock(&pPool->mutex);
+        }
+    }
+    free(p4BPP);
+    free(pWork->pHeap); // the page index belongs to the caller
+    free(pWork->pStripHeap);
+    return NULL;
+} /* TIFFPageWorker() */
+//
+// Decode every page of the document, spread across iThreads threads
+// (including the calling one). The draw callback is called from all of the
+// threads at once; TIFFDRAW.iPage tells which page the line belongs to.
+// returns TIFF_SUCCESS or the error of the first page which failed
+//
+static int TIFFDecodePages(TIFFIMAGE *pPage, int iThreads)
+{
+    TIFFPAGEPOOL pool;
+    TIFFPAGEWORKER *pWorkers;
+    int i, iStarted, iPages;
+
+    pPage->iError = TIFF_SUCCESS;
+    iPages = TIFFPageCount(pPage);
+    if (iPages == 0)
+    {
+        if (pPage->iError == TIFF_SUCCESS)
+            pPage->iError = TIFF_INVALID_FILE;
+        return pPage->iError;
+    }
+    if (iThreads > iPages) iThreads = iPages;
+    if (iThreads > TIFF_MAX_THREADS) iThreads = TIFF_MAX_THREADS;
+    if (iThreads < 1) iThreads = 1;
+    pWorkers = (TIFFPAGEWORKER *)malloc(iThreads * sizeof(TIFFPAGEWORKER));
+    if (pWorkers == NULL)
+    {
+        pPage->iError = TIFF_OUT_OF_MEMORY;
+        return TIFF_OUT_OF_MEMORY;
+    }
+    memset(&pool, 0, sizeof(pool));
+    pool.pPage = pPage;
+    pool.pfnRead = pPage->pfnRead;
+    pool.pfnSeek = pPage->pfnSeek;
+    pool.iPages = iPages;
+    pthread_mutex_init(&pool.mutex, NULL);
+    for (i=0; i<iThreads; i++)
+    {
+        memcpy(&pWorkers[i].tiff, pPage, sizeof(TIFFIMAGE));
+        pWorkers[i].tiff.pArena = NULL; // each one allocates its own buffers
+        pWorkers[i].tiff.pHeap = NULL;
+        pWorkers[i].tiff.iHeapSize = 0;
+        pWorkers[i].tiff.pStripHeap = NULL;
+        pWorkers[i].tiff.iStripHeapSize = 0;
+        pWorkers[i].tiff.pStripBuf = NULL; // the caller's can't be shared
+        pWorkers[i].tiff.iThreads = 0;
+        pWorkers[i].tiff.iReadAhead = 0; // the pages share the file
+        if (!TIFFPositional(pPage)) // the threads share a file position
+        {
+            pWorkers[i].tiff.pfnRead = TIFFLockedRead;
+            pWorkers[i].tiff.pfnSeek = TIFFLockedSeek;
+            pWorkers[i].tiff.TIFFFile.pPool = &pool;
+        }
+        pWorkers[i].pPool = &pool;
+    }
+    // worker 0 is the calling thread
+    for (iStarted=1; iStarted<iThreads; iStarted++)
+    {
+        if (pthread_create(&pWorkers[iStarted].tid, NULL, TIFFPageWorker, &pWorkers[iStarted]) != 0)
+            break;
+    }
+    TIFFPageWorker(&pWorkers[0]);
+    for (i=1; i<iStarted; i++)
+        pthread_join(pWorkers[i].tid, NULL);
+    pthread_mutex_destroy(&pool.mutex);
+    free(pWorkers);
+    pPage->iError = pool.iError;
+    return pool.iError;
+} /* TIFFDecodePages() */
+#endif // TIFF_THREADS
 #endif // NO_RAM
 
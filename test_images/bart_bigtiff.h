@@ -0,0 +1,66 @@
+//
+// bart_bigtiff
+// Data size = 870 bytes
+//
+// BigTIFF (Motorola), Compression=G4, 250 x 122, 1-Bpp, 4 strips with 8-byte offsets
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t bart_bigtiff[] PROGMEM = {
+	0x4d,0x4d,0x00,0x2b,0x00,0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0xa2,
+	0xff,0xff,0xe6,0x4a,0x85,0x32,0x50,0xc2,0x07,0x40,0xc2,0x0e,0x88,0x39,0xc9,0xf3,
+	0x31,0xd1,0x70,0x21,0x03,0x10,0xf4,0x66,0x0c,0x37,0x48,0xe8,0x08,0xcb,0x77,0x56,
+	0x5e,0x5d,0x90,0xd0,0x25,0x55,0xb7,0x21,0xab,0x56,0x93,0xe7,0x83,0x5a,0x97,0x65,
+	0xf7,0x2a,0x03,0x3f,0xf4,0x1d,0x91,0x67,0xf8,0xf4,0xb4,0x95,0xe9,0x57,0x9c,0x7e,
+	0x97,0xd5,0xad,0x07,0x35,0x17,0xed,0x53,0x0f,0x7b,0xe2,0xa0,0xc3,0xc3,0x2b,0x22,
+	0xe3,0xe1,0xe8,0xc3,0xb4,0x41,0x15,0x79,0x1d,0xaa,0x5e,0x1c,0x3e,0x24,0x58,0x48,
+	0x28,0x00,0x80,0x08,0x3a,0xc4,0x78,0xb9,0x95,0x23,0x3c,0x29,0x0b,0x8a,0xb0,0xd0,
+	0x45,0xce,0x96,0x1b,0x23,0x40,0x81,0x20,0x61,0xe8,0x97,0x52,0xe9,0x36,0x86,0x0c,
+	0x85,0x28,0xa0,0x40,0xd4,0x3f,0xb7,0x86,0x41,0xfc,0xca,0x29,0x38,0x61,0xfd,0xb4,
+	0x5c,0xc9,0x3c,0x32,0x0b,0xb8,0x3d,0x26,0xc1,0x87,0xf7,0xa4,0x15,0x31,0x0f,0x49,
+	0xba,0xd6,0xda,0x49,0x28,0x64,0x6e,0x45,0x76,0xa9,0x36,0x95,0x6a,0xf4,0xb6,0x28,
+	0x30,0xd6,0x9c,0x20,0xba,0xb0,0xfa,0xdb,0x0d,0xaf,0xa5,0xf6,0x1a,0x49,0x65,0x20,
+	0x61,0xb5,0x49,0xbf,0xeb,0xa5,0x91,0x20,0x22,0x61,0xfe,0xdf,0xe6,0x71,0xa5,0x91,
+	0x70,0x7a,0x7f,0x0c,0x3f,0xa4,0xb5,0x92,0xb0,0xab,0x7e,0xdf,0xfd,0x72,0x0a,0x2a,
+	0xf9,0x3d,0xa7,0x43,0xe6,0x4f,0xac,0xa9,0x87,0xf4,0xf0,0x81,0x56,0xab,0x5c,0x30,
+	0xbe,0xf0,0x82,0xcc,0x3b,0x55,0xea,0xa1,0x7a,0xf5,0xec,0xdd,0xf5,0xf0,0x4d,0xef,
+	0x86,0x1d,0x24,0x58,0xe2,0x3f,0x4b,0xfe,0xb6,0xfd,0x3f,0xff,0xb6,0xd2,0x41,0x87,
+	0xf0,0xcb,0x7e,0xba,0xf7,0x8f,0x7f,0x6d,0xfd,0x2f,0x76,0xd2,0x05,0xa5,0xb6,0xfc,
+	0x7f,0xda,0x82,0x05,0xd2,0x74,0xf5,0xf6,0xdb,0x4a,0x0b,0xf1,0xb7,0xfd,0xb0,0xc2,
+	0x4f,0xf6,0xe2,0xbd,0xd8,0x61,0x20,0xdf,0xd9,0x63,0x89,0x06,0xe3,0x3e,0xc5,0x37,
+	0xf6,0x28,0x90,0x17,0xc3,0x09,0x87,0xf9,0x12,0xb8,0x2e,0xa0,0xc1,0x02,0xfe,0x11,
+	0xd0,0x50,0xa4,0x55,0xf4,0x21,0x05,0xf4,0x67,0x1a,0x25,0xe4,0x51,0xa2,0x16,0x6e,
+	0x82,0x05,0xff,0x85,0x20,0xb8,0x40,0x78,0xc2,0xff,0x21,0x51,0xa4,0x41,0xab,0xc9,
+	0xb8,0x78,0x6f,0xfc,0xe2,0x10,0xa2,0xf8,0x67,0xc6,0xdb,0x0f,0xe9,0x2f,0x46,0xa0,
+	0xca,0x06,0xf6,0xff,0xea,0x91,0x13,0x10,0x31,0x64,0x44,0x7e,0x08,0x3f,0xff,0x92,
+	0x99,0xf3,0x1e,0x49,0x01,0x3f,0xfa,0x5b,0x7a,0x6d,0xc8,0xb5,0xff,0xfb,0xb9,0x98,
+	0x23,0x72,0x20,0x50,0x5f,0xfd,0x76,0x30,0xb2,0x04,0x14,0x38,0x00,0x80,0x08,0x00,
+	0x34,0x88,0xec,0xd2,0x2f,0x11,0x91,0xd6,0x25,0x91,0xa8,0x0c,0x17,0x22,0x38,0x18,
+	0x22,0x6f,0xbb,0x7f,0xf2,0x14,0x87,0xcd,0xe4,0x36,0x13,0x77,0xf6,0xdf,0xd9,0x2a,
+	0x99,0x71,0x9a,0xc1,0x83,0x58,0x7d,0xff,0x69,0x54,0x26,0x32,0x10,0x31,0x0b,0xed,
+	0xc7,0xf4,0xc2,0x23,0x40,0xec,0xc1,0x3b,0x8e,0xf4,0x83,0x08,0x8b,0x82,0x5f,0x7e,
+	0x42,0x0a,0xf1,0x25,0x81,0xde,0xde,0x11,0x14,0x45,0x10,0xce,0x62,0x91,0xd8,0x60,
+	0xfe,0xc2,0x24,0xa3,0x34,0x10,0x6e,0x32,0xa7,0x75,0x85,0xee,0x09,0x37,0x86,0x61,
+	0xc8,0x34,0xdd,0x20,0x7b,0x71,0x0b,0x6b,0x33,0x06,0x90,0x91,0xd9,0x33,0xc4,0x16,
+	0x39,0x4e,0x1b,0x02,0x40,0xf9,0x14,0x57,0x95,0x01,0x80,0x90,0xd8,0x57,0x84,0x8c,
+	0x05,0x8c,0x83,0xfd,0x13,0x98,0x85,0x6f,0x09,0x30,0x5b,0xd0,0x53,0x0e,0x79,0x0e,
+	0x77,0x8f,0x09,0x08,0xd8,0x78,0x20,0xac,0x61,0x05,0x0e,0x7c,0x48,0x72,0xe1,0x61,
+	0x88,0x59,0x09,0x21,0x46,0x69,0x15,0x0f,0xff,0xf0,0x01,0x00,0x10,0x00,0xc0,0x04,
+	0x00,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x74,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x02,0x6e,0x00,0x00,0x00,0x64,0x00,0x00,0x01,0x4b,0x00,0x00,0x00,0xad,0x00,0x00,
+	0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x09,0x01,0x00,0x00,0x04,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0xfa,0x00,0x00,0x00,0x00,0x01,0x01,
+	0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x7a,0x00,0x00,
+	0x00,0x00,0x01,0x02,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x03,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x06,0x00,0x03,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x11,
+	0x00,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x02,0x72,0x01,0x15,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x01,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x16,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x00,0x00,0x00,0x28,0x00,0x00,0x00,0x00,0x01,0x17,0x00,0x04,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x92,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00};
@@ -0,0 +1,103 @@
+//
+// bart_ccitt
+// CCITTFaxDecode streams of a PDF file, 250 x 122, 1-Bpp
+// bart_ccitt_k4: K=4, EncodedByteAlign, no EOLs (757 bytes)
+// bart_ccitt_g4: K=-1, EncodedByteAlign, ends with an EOFB (649 bytes)
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t bart_ccitt_k4[] PROGMEM = {
+	0xae,0xb6,0x40,0x40,0x40,0xae,0xb6,0x40,0x40,0x40,0xae,0xb6,0x40,0x40,0x40,0xae,
+	0xb6,0x40,0x40,0x40,0xae,0xb6,0x40,0x40,0x19,0x2a,0x14,0xc9,0x43,0x2e,0x14,0xcc,
+	0x20,0x61,0x07,0x22,0x0e,0x72,0x7c,0xcc,0x70,0x22,0xe0,0x42,0x06,0x21,0xc0,0xc8,
+	0xbd,0x30,0x60,0x80,0x8a,0x80,0x24,0x74,0x04,0x65,0xbb,0x80,0x2b,0x2f,0x2e,0xc8,
+	0x68,0x12,0x55,0x6d,0xc8,0x6a,0xd4,0xc8,0x65,0xad,0x3f,0x4b,0x83,0x59,0x00,0x25,
+	0xd9,0x7d,0xca,0x80,0xcf,0x7e,0x83,0xb2,0x2c,0xe0,0x7c,0x7a,0x50,0xc9,0x3f,0x55,
+	0x40,0x9f,0x0a,0x3d,0x40,0x2f,0x38,0xfd,0x28,0x7a,0xb5,0xa0,0xe0,0x1a,0x8b,0xf6,
+	0xa9,0x87,0xd4,0x3d,0xad,0xd5,0xf3,0xb4,0x85,0xc6,0x70,0x43,0x2b,0x22,0xe3,0xe1,
+	0xe0,0x23,0x0e,0xd1,0x04,0x55,0xe4,0x76,0xa9,0x40,0x70,0xe1,0xf1,0x22,0xc2,0x41,
+	0x40,0xeb,0x0f,0x39,0xa9,0x1f,0x0a,0x17,0x2b,0x0d,0x02,0xe7,0xa0,0x25,0x86,0xc8,
+	0xd0,0x20,0x48,0x18,0x7a,0x25,0xd4,0xa0,0x69,0x36,0x86,0x0c,0x85,0x28,0xa0,0x40,
+	0xd4,0x38,0x7b,0x78,0x64,0x1f,0xcc,0xa2,0x93,0x86,0x1c,0xe9,0x0f,0x4d,0x93,0x73,
+	0x27,0xab,0x05,0xdc,0x65,0xe2,0xee,0xa6,0x56,0x54,0x7b,0xd2,0x0a,0x98,0x87,0xa4,
+	0xdd,0x40,0x56,0xda,0x49,0x28,0x64,0x6e,0x45,0x76,0xa9,0x36,0x94,0x2d,0x5e,0x96,
+	0xc5,0x06,0x1a,0xd3,0x84,0x14,0x87,0x0f,0x10,0x65,0xef,0x7d,0x04,0x0c,0x71,0x90,
+	0x43,0x20,0x70,0xa9,0xe8,0x7b,0x0d,0x24,0xb2,0x90,0x30,0xda,0xa4,0xdf,0x7a,0xe9,
+	0x64,0x48,0x08,0x98,0x7f,0xb7,0x7c,0xce,0x34,0xb2,0x2e,0x0f,0x4f,0xe1,0x87,0x87,
+	0x0f,0x22,0x70,0x2f,0x91,0xe2,0xb0,0xbd,0x45,0x5c,0xa2,0x28,0x33,0x80,0x7f,0xae,
+	0x41,0x45,0x5f,0x27,0xb4,0xe0,0x21,0xf3,0x27,0xd6,0x54,0xc3,0xfa,0x78,0x40,0xa0,
+	0x2d,0x56,0xb8,0x61,0x7d,0xe1,0x05,0xa2,0x1c,0xa9,0x3c,0x32,0x88,0x8c,0x90,0xbe,
+	0xae,0x98,0xe9,0x09,0x9e,0xa0,0x76,0x6e,0xfa,0xf8,0x26,0xf7,0xc3,0x0e,0x24,0x8b,
+	0x1c,0x47,0xe9,0x7f,0xd6,0xdc,0x74,0xff,0xfe,0xdb,0x49,0x06,0x1c,0x9e,0x1e,0xc6,
+	0xe6,0xf2,0x7a,0x22,0x22,0x49,0x0e,0xa8,0x1c,0x52,0x54,0x7b,0x6f,0xe9,0x7b,0xb6,
+	0x90,0x2c,0x25,0xb6,0xfc,0x7f,0xda,0x82,0x05,0x69,0x3a,0x7a,0xfb,0x6d,0xa5,0x05,
+	0xd2,0x1e,0xa0,0x8f,0x54,0x20,0x71,0x24,0x1b,0xac,0xc8,0x31,0x73,0xd4,0x7b,0x71,
+	0x5e,0xec,0x30,0x90,0x6e,0x7b,0x2c,0x71,0x20,0xdc,0x67,0xd8,0xa6,0xe0,0x7b,0x14,
+	0x48,0x0b,0xe1,0x84,0xc3,0x80,0xd2,0x1e,0x20,0x4a,0xea,0x03,0x92,0x41,0xb5,0x02,
+	0x82,0x8a,0x80,0x7c,0x23,0xa0,0xa1,0x48,0xab,0xe8,0x42,0x0a,0x7a,0x33,0x8d,0x12,
+	0xf2,0x28,0xd1,0x0b,0x37,0x41,0x02,0x80,0x7f,0xc2,0x90,0x5c,0x20,0x3c,0x61,0x40,
+	0xd2,0x1e,0x44,0xe1,0x51,0x75,0x40,0x6a,0xf3,0x70,0x91,0x6c,0xc3,0xac,0x7f,0x38,
+	0x84,0x28,0xbe,0x19,0xf1,0xb6,0xc3,0x80,0x7a,0x4b,0xd1,0xa8,0x32,0x81,0xbd,0xb8,
+	0x7f,0xaa,0x44,0x4c,0x40,0xc5,0x91,0x11,0xf8,0x20,0xe0,0xd2,0x1e,0x3c,0xf0,0xca,
+	0xb8,0xa6,0x0c,0x62,0x28,0xde,0x24,0x04,0x20,0x7f,0xe9,0x6d,0xe9,0xb7,0x22,0xd6,
+	0x7f,0xfb,0xb9,0x98,0x23,0x72,0x20,0x50,0x50,0x7f,0xeb,0xb1,0x85,0x90,0x20,0xa1,
+	0xc0,0xd2,0x1d,0xd2,0x78,0x65,0xac,0x59,0x54,0x06,0x1c,0x87,0x03,0x02,0x6e,0xb0,
+	0x6e,0xdf,0xfc,0x85,0x21,0xf3,0x79,0x0d,0x84,0xdc,0x3f,0xb6,0xfe,0xc9,0x54,0xcb,
+	0x8c,0xd6,0x0c,0x1a,0xc3,0xc0,0x5f,0xf6,0x95,0x42,0x63,0x21,0x03,0x10,0xa0,0x9e,
+	0x1e,0x44,0x38,0x18,0x0e,0x2d,0xd3,0xc5,0xc4,0x1a,0x07,0xa4,0x10,0x77,0x1d,0xe9,
+	0x06,0x11,0x17,0x04,0xb8,0x6f,0xc8,0x41,0x5e,0x24,0xb0,0x3b,0xc0,0x37,0x84,0x45,
+	0x11,0x44,0x33,0x98,0xa4,0x76,0x18,0x3c,0xa2,0x1d,0xe1,0x28,0x88,0xa0,0x1b,0x8c,
+	0xb5,0x7b,0xac,0x28,0x80,0x6e,0x09,0x37,0x86,0x61,0xc8,0x34,0xdd,0x20,0x78,0x37,
+	0x10,0xb6,0xb3,0x30,0x69,0x09,0x1d,0x93,0x38,0x44,0x16,0x39,0x4e,0x1b,0x02,0x40,
+	0xf0,0x90,0x28,0xae,0x32,0x50,0x18,0x98,0xf6,0xaa,0x30,0xaf,0x09,0x18,0x0b,0x0c,
+	0x83,0xfd,0x13,0x98,0x85,0x37,0x84,0x98,0x28,0xad,0x06,0x32,0x4e,0x64,0x43,0xf2,
+	0x1c,0x1d,0xe3,0xc2,0x42,0x30,0x30,0xf0,0x41,0x40,0x31,0x84,0x14,0xee,0x83,0xf1,
+	0x24,0x4c,0x07,0x2e,0x16,0x06,0x21,0x40,0x48,0x49,0x0a,0x00,0xef,0x4a,0x45,0x40,
+	0x0c,0x40,0x40,0xae,0xb6,0x40,0x40,0x40,0xae,0xb6,0x40,0x40,0x40,0xae,0xb6,0x40,
+	0x40,0x40,0xae,0xb6,0x40,
+};
+const uint8_t bart_ccitt_g4[] PROGMEM = {
+	0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+	0x80,0x80,0x80,0x32,0x54,0x28,0x32,0x50,0xc2,0x07,0x40,0xc2,0x0e,0x44,0x1c,0xe4,
+	0xf9,0x98,0xe0,0x45,0xc0,0x84,0x0c,0x43,0x80,0xa3,0x30,0x61,0xb8,0x48,0xe8,0x08,
+	0xcb,0x77,0x56,0x5e,0x5d,0x90,0xd0,0x24,0xaa,0xdb,0x90,0xd5,0xa8,0xd2,0x7c,0xf0,
+	0x6b,0x40,0x4b,0xb2,0xfb,0x95,0x01,0x9e,0xfd,0x07,0x64,0x59,0xc0,0xf8,0xf4,0xa0,
+	0xa4,0xaf,0x4a,0x5e,0x71,0xfa,0x50,0xf5,0x6b,0x41,0xc0,0x35,0x17,0xed,0x53,0x0e,
+	0xbd,0xf1,0x50,0x61,0xc0,0x86,0x56,0x45,0xc7,0xc3,0xc0,0x46,0x1d,0xa2,0x08,0xab,
+	0xc8,0xed,0x52,0x80,0xe1,0xc3,0xe2,0x45,0x84,0x82,0x80,0xe6,0x76,0x11,0x3e,0x0f,
+	0x08,0x50,0x4a,0x4b,0x0d,0x91,0xa0,0x40,0x90,0x30,0xf4,0x4b,0xa9,0x40,0xd2,0x6d,
+	0x0c,0x19,0x0a,0x51,0x40,0x81,0xa8,0x70,0xf6,0xf0,0xc8,0x3f,0x99,0x45,0x27,0x0c,
+	0x38,0xf6,0xd1,0x73,0x24,0xf0,0xc8,0x2e,0xe0,0xf4,0x9b,0x06,0x1c,0xf7,0xa4,0x15,
+	0x31,0x0f,0x49,0xba,0x80,0xad,0xb4,0x92,0x50,0xc8,0xdc,0x8a,0xed,0x52,0x6d,0x28,
+	0x5a,0xbd,0x2d,0x8a,0x0c,0x35,0xa7,0x08,0x28,0xd5,0x87,0xd6,0xd8,0x6d,0x7d,0x28,
+	0xf6,0x1a,0x49,0x65,0x20,0x61,0xb5,0x49,0xbe,0xf5,0xd2,0xc8,0x90,0x11,0x30,0xff,
+	0x6e,0xf9,0x9c,0x69,0x64,0x5c,0x1e,0x9f,0xc3,0x0e,0xf4,0x96,0xb2,0x56,0x15,0x6f,
+	0xdb,0x80,0xff,0x5c,0x82,0x8a,0xbe,0x4f,0x69,0xc0,0x43,0xe6,0x4f,0xac,0xa9,0x87,
+	0xf4,0xf0,0x81,0x40,0x5a,0xad,0x70,0xc2,0xfb,0xc2,0x0a,0x98,0x76,0xab,0xd5,0x42,
+	0xf5,0xea,0xec,0xdd,0xf5,0xf0,0x4d,0xef,0x86,0x1c,0x49,0x16,0x38,0x8f,0xd2,0xff,
+	0xad,0xb8,0xe9,0xff,0xfd,0xb6,0x92,0x0c,0x38,0xf0,0xcb,0x7e,0xba,0xf7,0x8f,0x70,
+	0xf6,0xdf,0xd2,0xf7,0x6d,0x20,0x58,0x4b,0x6d,0xf8,0xff,0xb5,0x04,0x0a,0xd2,0x74,
+	0xf5,0xf6,0xdb,0x4a,0x0a,0xf8,0xdb,0xfe,0xd8,0x61,0x27,0x80,0xf6,0xe2,0xbd,0xd8,
+	0x61,0x20,0xdc,0xf6,0x58,0xe2,0x41,0xb8,0xcf,0xb1,0x4d,0xc0,0xf6,0x28,0x90,0x17,
+	0xc3,0x09,0x87,0xf9,0x12,0xb8,0x2e,0xa0,0xc1,0x02,0xc0,0xf8,0x47,0x41,0x42,0x91,
+	0x57,0xd0,0x84,0x14,0xf4,0x67,0x1a,0x25,0xe4,0x51,0xa2,0x16,0x6e,0x82,0x05,0xff,
+	0x85,0x20,0xb8,0x40,0x78,0xc2,0x80,0xfe,0x42,0xa3,0x48,0x83,0x57,0x93,0x70,0xf0,
+	0xdc,0xfe,0x71,0x08,0x51,0x7c,0x33,0xe3,0x6d,0x87,0xf4,0x97,0xa3,0x50,0x65,0x03,
+	0x7b,0x70,0xff,0x54,0x88,0x98,0x81,0x8b,0x22,0x23,0xf0,0x41,0xc0,0xff,0xf2,0x53,
+	0x3e,0x63,0xc9,0x20,0x24,0xff,0xd2,0xdb,0xd3,0x6e,0x45,0xac,0xff,0xf7,0x73,0x30,
+	0x46,0xe4,0x40,0xa0,0xa0,0xff,0xd7,0x63,0x0b,0x20,0x41,0x43,0x80,0xef,0xfa,0xb7,
+	0xe4,0x0c,0x09,0xb8,0xdd,0xbf,0xf9,0x0a,0x43,0xe6,0xf2,0x1b,0x09,0xb8,0x7f,0x6d,
+	0xfd,0x92,0xa9,0x97,0x19,0xac,0x18,0x35,0x87,0x80,0xbf,0xed,0x2a,0x84,0xc6,0x42,
+	0x06,0x21,0x40,0xf6,0xe3,0xfa,0x61,0x11,0xa0,0x76,0x60,0x80,0xee,0x3b,0xd2,0x0c,
+	0x22,0x2e,0x09,0x70,0xdf,0x90,0x82,0xbc,0x49,0x60,0x77,0x80,0x6f,0x08,0x8a,0x22,
+	0x88,0x67,0x31,0x48,0xec,0x30,0x78,0xec,0x22,0x4a,0x33,0x41,0x06,0xe3,0x2a,0x77,
+	0x58,0x58,0xdc,0x12,0x6f,0x0c,0xc3,0x90,0x69,0xba,0x40,0xf0,0x6e,0x21,0x6d,0x66,
+	0x60,0xd2,0x12,0x3b,0x26,0x70,0x88,0x2c,0x72,0x9c,0x36,0x04,0x81,0xe0,0x91,0x45,
+	0x79,0x50,0x18,0x09,0x0c,0x61,0x5e,0x12,0x30,0x16,0x19,0x07,0xfa,0x27,0x31,0x0a,
+	0x6f,0x09,0x30,0x50,0xbd,0x05,0x30,0xe7,0x90,0xe0,0x3b,0xc7,0x84,0x84,0x60,0x61,
+	0xe0,0x82,0x80,0x63,0x08,0x28,0x0e,0x7c,0x48,0x0e,0x5c,0x2c,0x0c,0x42,0x80,0x90,
+	0x92,0x14,0x66,0x91,0x50,0x18,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
+	0x80,0x80,0x80,0x80,0x80,0x80,0x00,0x10,0x01,
+};
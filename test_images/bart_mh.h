@@ -0,0 +1,84 @@
+//
+// bart_mh
+// Data size = 1164 bytes
+//
+// TIFF, Compression=CCITT RLE (Modified Huffman), 250 x 122, 1-Bpp
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t bart_mh[] PROGMEM = {
+	0x49,0x49,0x2a,0x00,0x1a,0x04,0x00,0x00,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,
+	0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,
+	0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x92,0xa1,
+	0x6c,0x70,0x92,0x86,0x5c,0x29,0x98,0x90,0x41,0x6a,0x0c,0x25,0x80,0x90,0x30,0x73,
+	0x9f,0x14,0x64,0xa0,0x91,0x77,0x01,0xb1,0x01,0x15,0x40,0x91,0x7a,0x60,0xc1,0x01,
+	0x15,0x00,0x90,0x8b,0x40,0x42,0x1b,0xb5,0x30,0x90,0xc7,0xab,0xc8,0x3a,0x03,0x40,
+	0x90,0x90,0xca,0xab,0xad,0x27,0x0d,0x5a,0x80,0x90,0xcb,0x5a,0x7e,0x97,0x06,0xb2,
+	0x00,0x92,0x7a,0xaa,0x73,0xe7,0xd4,0x06,0x72,0x00,0x92,0x7a,0xaa,0x70,0xe7,0x38,
+	0x59,0x86,0x92,0x7a,0xaa,0x62,0x4e,0x15,0x7a,0x00,0x92,0x7e,0xaa,0x81,0x3e,0x14,
+	0x7a,0x80,0x95,0x75,0x55,0x31,0xc7,0xf0,0x9b,0xa8,0x95,0x75,0x54,0xe7,0x39,0xc2,
+	0x43,0xd0,0xa8,0xb6,0x95,0x55,0x4e,0x8a,0x98,0xa0,0xa4,0x00,0xa8,0x7b,0x5b,0xab,
+	0xe7,0x69,0x0b,0x8c,0xe0,0xa8,0x45,0x91,0x56,0x64,0x96,0x91,0x49,0x9c,0xd6,0x1c,
+	0x64,0xa0,0x8a,0xb2,0x48,0x77,0x36,0x50,0x68,0xd6,0x1c,0x45,0x50,0xc2,0x9c,0x90,
+	0x3c,0x32,0x86,0x18,0xd6,0x1e,0x73,0x52,0x3e,0x14,0x2e,0x56,0x1a,0x05,0xcf,0x40,
+	0xd2,0x7a,0xd8,0xd0,0x23,0x91,0xc6,0x0b,0x28,0x2e,0x10,0x58,0xf5,0xd2,0x1e,0xe6,
+	0x04,0x0d,0xc3,0x0a,0x51,0x04,0x64,0x18,0xb8,0xc3,0xd2,0x1e,0xf6,0x60,0x1b,0xea,
+	0x0f,0xf2,0x88,0x1b,0xd1,0x94,0x8d,0x00,0xd2,0x1e,0x9b,0x26,0xe6,0x4f,0x56,0x0b,
+	0xb8,0xcb,0xc5,0xdd,0x4c,0xac,0xa8,0xd2,0x1e,0xa4,0x4e,0x99,0xde,0x30,0x32,0x86,
+	0x42,0x1a,0x76,0x54,0x67,0xd3,0x78,0xf2,0x8a,0x67,0x71,0x71,0xb8,0xae,0x55,0xb1,
+	0x8c,0x43,0x28,0x34,0x00,0x0e,0x7d,0x0c,0x25,0xe7,0x90,0x30,0xc6,0x16,0x86,0x32,
+	0x07,0x0b,0x18,0x60,0x0e,0x1e,0x20,0xcb,0xde,0xfa,0x08,0x18,0xe3,0x20,0x86,0x40,
+	0xe1,0x53,0xd0,0x0e,0x1e,0x0c,0x93,0xde,0xfe,0x48,0x18,0x83,0x38,0xd3,0xca,0x21,
+	0x43,0xd0,0x0e,0x1e,0x20,0x69,0xee,0x73,0x84,0x80,0x8a,0x43,0xc9,0xe5,0x10,0xa9,
+	0x86,0x0e,0x1e,0x22,0x70,0x51,0x8e,0x90,0xb8,0x3c,0xf8,0xd3,0xca,0x21,0x73,0x40,
+	0x0e,0x1e,0x44,0xe0,0x5f,0x23,0xc5,0x61,0x7a,0x8a,0xb9,0x44,0x50,0x67,0x0e,0x1e,
+	0x44,0xe0,0x5e,0xd9,0xe0,0x51,0x6d,0xc5,0x5c,0x79,0x10,0xb8,0xe8,0x20,0x54,0x4f,
+	0x27,0xae,0x44,0xa6,0x1e,0x2a,0xea,0x19,0xe1,0x52,0x20,0x40,0x88,0xe3,0x19,0x43,
+	0x44,0xaa,0x2e,0x55,0xd4,0x2a,0x42,0x65,0xa0,0x44,0x39,0x52,0x78,0x65,0x11,0x19,
+	0x21,0x7d,0x5d,0x31,0xd2,0x13,0x3d,0x40,0x44,0x38,0xee,0x1e,0x78,0x67,0x71,0x19,
+	0x24,0x8a,0xaa,0x85,0x48,0x54,0xc3,0x3c,0x3b,0x1c,0x1d,0xe1,0x9c,0x41,0xe4,0x92,
+	0x2a,0xaa,0x19,0xe1,0x63,0x20,0x3c,0x3d,0x00,0x8f,0x0c,0xe2,0x0f,0x24,0x91,0x57,
+	0x52,0x3c,0x52,0x67,0x3c,0x3d,0x8d,0xcd,0xe4,0xf4,0x44,0x44,0x92,0x1d,0x50,0x38,
+	0xa4,0xa8,0x3c,0x3d,0xcd,0xdb,0xc9,0xe7,0x83,0x89,0x22,0x2a,0xe1,0x10,0xb8,0x94,
+	0xa4,0xf7,0xb7,0x9e,0x4e,0x28,0x71,0x24,0x45,0x5b,0x4e,0xc5,0x04,0x20,0xa4,0x3d,
+	0x48,0x73,0x1e,0xac,0x40,0xe2,0x48,0x3a,0xb7,0x53,0x15,0x2d,0x40,0xa4,0x3d,0x41,
+	0x1e,0xa8,0x40,0xe2,0x48,0x37,0x59,0x90,0x62,0xe7,0xa8,0xa4,0x3c,0x71,0x07,0x0c,
+	0xbd,0x22,0x4b,0x49,0x39,0x4c,0x8a,0x9e,0x80,0xa4,0x3c,0x86,0x38,0x65,0x0c,0x89,
+	0x2d,0x21,0x80,0x41,0x63,0x0c,0xa4,0x3c,0x40,0x66,0x90,0x14,0x92,0xd2,0x2e,0x0e,
+	0x0a,0x68,0xa4,0x3c,0x40,0x95,0xd4,0x07,0x24,0x83,0x6a,0x05,0x05,0x15,0x00,0xa4,
+	0x3c,0x40,0xf4,0x17,0xc1,0x71,0x56,0x1c,0x1d,0xb0,0xc5,0x0c,0xa4,0x3c,0x89,0xc0,
+	0xc7,0x17,0x8a,0x34,0x16,0x71,0x1e,0xc8,0x1d,0x40,0xa4,0x3c,0x89,0xc0,0xc7,0x3a,
+	0x02,0xe1,0x01,0xf2,0xd9,0x33,0x4e,0xa4,0x3c,0x89,0xc2,0xa2,0xea,0x80,0xd5,0xe6,
+	0xe1,0x22,0xd9,0x87,0x58,0xa4,0x3c,0x89,0xf1,0x1a,0x77,0xc1,0xa7,0xe3,0x7b,0x66,
+	0x0f,0x50,0xa4,0x3c,0x79,0xe1,0x1a,0x7a,0xa0,0xca,0x39,0x8f,0x6c,0x08,0xf4,0xa4,
+	0x3c,0x79,0xe1,0x95,0x70,0x98,0x84,0x0a,0x22,0xf9,0x68,0x42,0x00,0xa4,0x3c,0x79,
+	0xe1,0x95,0x71,0x4c,0x18,0xc4,0x51,0xbc,0x48,0x08,0x40,0xa4,0x3c,0x79,0xe1,0x95,
+	0x51,0x55,0xa0,0xc6,0x4e,0xde,0x55,0x16,0xb0,0xa4,0x3c,0x79,0xe1,0x95,0x51,0x5f,
+	0xa9,0x4c,0x12,0xd8,0xe2,0x05,0x18,0xc0,0xa4,0x3c,0x79,0xe1,0x96,0xac,0xaf,0xa8,
+	0x32,0x9c,0x87,0x02,0x0a,0x0d,0x38,0xa4,0x3b,0xa4,0xf0,0xcb,0x58,0xb2,0xa8,0x0c,
+	0x39,0x0e,0x06,0x04,0xdd,0x60,0xa4,0xf1,0xe1,0xe1,0x96,0xb1,0x65,0x50,0x52,0x21,
+	0xc8,0x7b,0xc3,0x61,0x31,0xd4,0x3e,0xf1,0xe7,0x86,0x7a,0xc5,0x95,0x65,0x53,0x71,
+	0xd6,0x0c,0x56,0x1f,0x50,0x3c,0x3c,0x79,0xe1,0x90,0x71,0x6e,0x9d,0x8c,0x0e,0x10,
+	0x30,0x18,0x4a,0xc0,0x3c,0x3c,0x88,0x70,0x30,0x1c,0x5b,0xa7,0x8b,0x88,0x34,0x0f,
+	0x48,0x20,0x3c,0x3b,0x38,0x66,0x86,0xcb,0x3a,0xe5,0x06,0x2e,0x09,0x8c,0x18,0x3c,
+	0xf1,0xc3,0x34,0x30,0x82,0xb5,0x76,0xe6,0x1d,0xe0,0x60,0x44,0x3d,0x31,0x44,0x44,
+	0x06,0x73,0x15,0x56,0xc3,0x07,0x2e,0x44,0x3b,0xc2,0x51,0x11,0x40,0x37,0x19,0x6a,
+	0xf7,0x58,0x51,0x00,0x44,0xf3,0x8a,0x4e,0x45,0x90,0xe0,0xd3,0x76,0x8f,0x65,0xc5,
+	0x10,0x22,0x1c,0x29,0x88,0x85,0xd4,0xc1,0xa4,0x83,0xd9,0x33,0x18,0x20,0x38,0xd4,
+	0x32,0x4e,0x1b,0x0e,0x5b,0x03,0xc6,0x00,0x20,0x51,0x5c,0x64,0xa0,0x31,0x31,0xed,
+	0x54,0x0c,0xc5,0xe4,0xf0,0x30,0x5e,0x02,0xec,0x94,0x59,0x07,0xf8,0xb9,0xcc,0x17,
+	0xda,0xc8,0x5a,0x07,0xe8,0x61,0x1c,0x3e,0xd2,0x80,0x5a,0x0c,0x64,0x9c,0xc8,0x87,
+	0xe4,0x38,0xde,0x3b,0xaa,0x29,0x08,0xdf,0x1b,0xc1,0x8e,0x40,0xc0,0xdf,0x88,0x81,
+	0xc9,0x40,0xdd,0x07,0xe2,0x48,0x98,0xda,0x0d,0xc2,0xc8,0x08,0xd8,0x60,0xf2,0x1a,
+	0xd8,0x61,0x24,0x28,0xde,0x94,0x8a,0x80,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,
+	0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,
+	0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x5d,0x6c,0x09,0x00,0x00,0x01,0x04,0x00,
+	0x01,0x00,0x00,0x00,0xfa,0x00,0x00,0x00,0x01,0x01,0x04,0x00,0x01,0x00,0x00,0x00,
+	0x7a,0x00,0x00,0x00,0x02,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,
+	0x03,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x06,0x01,0x03,0x00,
+	0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x11,0x01,0x04,0x00,0x01,0x00,0x00,0x00,
+	0x08,0x00,0x00,0x00,0x15,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,
+	0x16,0x01,0x04,0x00,0x01,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x17,0x01,0x04,0x00,
+	0x01,0x00,0x00,0x00,0x12,0x04,0x00,0x00,0x00,0x00,0x00,0x00};
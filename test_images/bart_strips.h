@@ -0,0 +1,64 @@
+//
+// bart_strips
+// Data size = 836 bytes
+//
+// TIFF, Compression=G4, Size: 250 x 122, 1-Bpp, 8 strips of 16 rows
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t bart_strips[] PROGMEM = {
+	0x49,0x49,0x2a,0x00,0xd2,0x02,0x00,0x00,0xff,0xff,0x00,0x10,0x01,0x00,0xe6,0x4a,
+	0x85,0x32,0x50,0xc2,0x07,0x40,0xc2,0x0e,0x88,0x39,0xc9,0xf3,0x31,0xd1,0x70,0x21,
+	0x03,0x10,0xf4,0x66,0x0c,0x37,0x48,0xe8,0x08,0xcb,0x77,0x56,0x5e,0x5d,0x90,0xd0,
+	0x25,0x55,0xb7,0x21,0xab,0x56,0x93,0xe7,0x83,0x5a,0x97,0x65,0xf7,0x2a,0x03,0x3f,
+	0xf4,0x1d,0x91,0x67,0xf8,0xf4,0xa0,0x02,0x00,0x20,0x32,0x4f,0x9a,0xa3,0x40,0x87,
+	0xe2,0x28,0xeb,0xce,0x3f,0x4b,0xea,0xd6,0x83,0x9a,0x8b,0xf6,0xa9,0x87,0xbd,0xf1,
+	0x50,0x61,0xe1,0x95,0x91,0x71,0xf0,0xf4,0x61,0xda,0x20,0x8a,0xbc,0x8e,0xd5,0x2f,
+	0x0e,0x1f,0x12,0x2c,0x24,0x17,0x99,0xd8,0x44,0xf8,0x3c,0x21,0x41,0x2a,0x58,0x6c,
+	0x8d,0x02,0x04,0x81,0x87,0xa2,0x5d,0x4b,0xa4,0xda,0x18,0x32,0x14,0xa2,0x81,0x03,
+	0x50,0xfe,0xde,0x19,0x07,0xf3,0x28,0xa4,0xe1,0x87,0xf6,0xd1,0x73,0x24,0xf0,0xc8,
+	0x2e,0xe0,0xf4,0x9b,0x06,0x1f,0xde,0x90,0x54,0xc4,0x3d,0x26,0xeb,0x5b,0x69,0x24,
+	0xa1,0x91,0xb9,0x15,0xda,0xa4,0xda,0x55,0xab,0xd2,0xd8,0xa0,0xc3,0x5a,0x70,0x82,
+	0x80,0x08,0x00,0x80,0x21,0xc4,0x78,0x90,0x64,0xbc,0x7d,0x9e,0x88,0x40,0xc1,0xe3,
+	0x24,0x11,0x19,0x10,0x71,0x15,0x3f,0xb0,0xd2,0x4b,0x29,0x03,0x0d,0xaa,0x4d,0xff,
+	0x5d,0x2c,0x89,0x01,0x13,0x0f,0xf6,0xff,0x33,0x8d,0x2c,0x8b,0x83,0xd3,0xf8,0x61,
+	0xfd,0x25,0xac,0x95,0x85,0x5b,0xf6,0xff,0xeb,0x90,0x51,0x57,0xc9,0xed,0x3a,0x1f,
+	0x32,0x7d,0x65,0x4c,0x3f,0xa7,0x84,0x0a,0xb5,0x5a,0xe1,0x85,0xf7,0x84,0x16,0x61,
+	0xda,0xaf,0x55,0x0b,0xd7,0xaf,0x66,0xef,0xaf,0x82,0x6f,0x7c,0x30,0xe9,0x22,0xc7,
+	0x11,0xfa,0x5f,0xf5,0xb7,0xe9,0xff,0xfd,0xb6,0x92,0x0c,0x3f,0x86,0x5b,0xf5,0xd7,
+	0xbc,0x7b,0xfb,0x6f,0xe9,0x7b,0xb6,0x90,0x2d,0x2d,0xb7,0xe3,0xfe,0xd4,0x10,0x2e,
+	0x93,0xa7,0xaf,0xb6,0xda,0x50,0x50,0x01,0x00,0x10,0x34,0x88,0xf1,0xa0,0x85,0xe3,
+	0x50,0x84,0x38,0x92,0x44,0x36,0x6b,0x32,0x41,0x91,0x73,0xfb,0x71,0x5e,0xec,0x30,
+	0x90,0x6f,0xec,0xb1,0xc4,0x83,0x71,0x9f,0x62,0x9b,0xfb,0x14,0x48,0x0b,0xe1,0x84,
+	0xc3,0xfc,0x89,0x5c,0x17,0x50,0x60,0x81,0x7f,0x08,0xe8,0x28,0x52,0x2a,0xfa,0x10,
+	0x82,0xfa,0x33,0x8d,0x12,0xf2,0x28,0xd1,0x0b,0x37,0x41,0x02,0xff,0xc2,0x90,0x5c,
+	0x20,0x3c,0x61,0x7f,0x90,0xa8,0xd2,0x20,0xd5,0xe4,0xdc,0x3c,0x37,0xfe,0x71,0x08,
+	0x51,0x7c,0x33,0xe3,0x6d,0x87,0xf4,0x97,0xa3,0x50,0x65,0x03,0x7b,0x7f,0xf5,0x48,
+	0x89,0x88,0x18,0xb2,0x22,0x3f,0x04,0x1f,0xff,0xc9,0x4c,0xf9,0x8f,0x24,0x80,0x9f,
+	0xfd,0x2d,0xbd,0x36,0xe4,0x5a,0xff,0xfd,0xdc,0xcc,0x11,0xb9,0x10,0x28,0x2f,0xfe,
+	0xbb,0x18,0x59,0x02,0x0a,0x1c,0x00,0x40,0x04,0x00,0x34,0x88,0xec,0xd2,0x2f,0x11,
+	0x91,0xd6,0x25,0x91,0xa8,0x0c,0x17,0x22,0x38,0x18,0x22,0x6f,0xbb,0x7f,0xf2,0x14,
+	0x87,0xcd,0xe4,0x36,0x13,0x77,0xf6,0xdf,0xd9,0x2a,0x99,0x71,0x9a,0xc1,0x83,0x58,
+	0x7d,0xff,0x69,0x54,0x26,0x32,0x10,0x31,0x0b,0xed,0xc7,0xf4,0xc2,0x23,0x40,0xec,
+	0xc1,0x3b,0x8e,0xf4,0x83,0x08,0x8b,0x82,0x5f,0x7e,0x42,0x0a,0xf1,0x25,0x81,0xde,
+	0xde,0x11,0x14,0x45,0x10,0xce,0x62,0x91,0xd8,0x60,0xfe,0xc2,0x24,0xa3,0x34,0x10,
+	0x6e,0x32,0xa7,0x75,0x85,0xee,0x09,0x37,0x86,0x61,0xc8,0x34,0xdd,0x20,0x7b,0x71,
+	0x0b,0x6b,0x33,0x06,0x90,0x91,0xd9,0x33,0xc4,0x16,0x39,0x4e,0x1b,0x02,0x40,0xf9,
+	0x14,0x57,0x95,0x01,0x80,0x90,0xd8,0x57,0x84,0x8c,0x05,0x8c,0x83,0xfd,0x13,0x98,
+	0x85,0x6f,0x09,0x30,0x50,0x01,0x00,0x10,0x2b,0x41,0x83,0x91,0x4e,0x64,0x88,0x8f,
+	0xce,0xf1,0xe1,0x21,0x1b,0x0f,0x04,0x15,0x8c,0x20,0xa1,0xcf,0x89,0x0e,0x5c,0x2c,
+	0x31,0x0b,0x21,0x24,0x28,0xcd,0x22,0xa1,0xfe,0x00,0x20,0x02,0xff,0xc0,0x04,0x00,
+	0x40,0x00,0x08,0x00,0x00,0x00,0x0e,0x00,0x00,0x00,0x4a,0x00,0x00,0x00,0xc4,0x00,
+	0x00,0x00,0x4a,0x01,0x00,0x00,0xda,0x01,0x00,0x00,0x68,0x02,0x00,0x00,0x8c,0x02,
+	0x00,0x00,0x05,0x00,0x00,0x00,0x3c,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x86,0x00,
+	0x00,0x00,0x8f,0x00,0x00,0x00,0x8e,0x00,0x00,0x00,0x24,0x00,0x00,0x00,0x05,0x00,
+	0x00,0x00,0x09,0x00,0x00,0x01,0x04,0x00,0x01,0x00,0x00,0x00,0xfa,0x00,0x00,0x00,
+	0x01,0x01,0x04,0x00,0x01,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x02,0x01,0x03,0x00,
+	0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x01,0x03,0x00,0x01,0x00,0x00,0x00,
+	0x04,0x00,0x00,0x00,0x06,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x11,0x01,0x04,0x00,0x08,0x00,0x00,0x00,0x92,0x02,0x00,0x00,0x15,0x01,0x03,0x00,
+	0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x16,0x01,0x04,0x00,0x01,0x00,0x00,0x00,
+	0x10,0x00,0x00,0x00,0x17,0x01,0x04,0x00,0x08,0x00,0x00,0x00,0xb2,0x02,0x00,0x00,
+	0x00,0x00,0x00,0x00};
@@ -0,0 +1,73 @@
+//
+// bart_tiles
+// Data size = 978 bytes
+//
+// TIFF, Compression=G4, Size: 250 x 122, 1-Bpp, 64 x 32 tiles
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t bart_tiles[] PROGMEM = {
+	0x49,0x49,0x2a,0x00,0x54,0x03,0x00,0x00,0xff,0xff,0xff,0xff,0x00,0x10,0x01,0x00,
+	0xff,0xff,0xff,0xff,0x00,0x10,0x01,0x00,0xff,0xff,0xe5,0x50,0xa5,0x43,0x08,0x1d,
+	0x03,0x08,0x3a,0x20,0xe7,0x27,0xce,0x8b,0x81,0x08,0x1b,0xa3,0x30,0x61,0xd2,0x3a,
+	0x02,0x3a,0xb2,0xf2,0xf5,0x5b,0xd2,0x7a,0x5d,0x97,0xff,0xa0,0xff,0x1c,0x00,0x40,
+	0x04,0x00,0xff,0xff,0xfc,0xbf,0x08,0x3d,0xe7,0x77,0xd9,0x0d,0x05,0x17,0x21,0xaa,
+	0x0f,0x3c,0x1a,0xd7,0x2a,0x03,0x3e,0xc8,0xb3,0xe9,0x40,0x04,0x00,0x40,0xe6,0xa2,
+	0xde,0x1d,0x18,0x77,0xe1,0xf9,0x9d,0xd2,0xc3,0x60,0xba,0x4d,0xaf,0xb7,0xfb,0x69,
+	0x7d,0xeb,0x5b,0x69,0x56,0xaf,0xea,0xc3,0xfe,0xc3,0x4b,0xeb,0xfe,0x67,0x1f,0xd2,
+	0x5f,0xfd,0x0f,0x99,0x3e,0xb5,0x5a,0xcc,0x3b,0x55,0xfe,0xcd,0xdf,0x5a,0x48,0xb1,
+	0xc4,0x7e,0xbd,0x3f,0xfe,0x19,0x6f,0xd7,0xf6,0xdf,0xd5,0x2d,0xb7,0xe3,0xd2,0x74,
+	0xf5,0x00,0x10,0x01,0xf9,0xac,0x5a,0x20,0x82,0x90,0xe1,0x13,0xe0,0xe4,0xd4,0x20,
+	0x48,0x18,0x78,0xc1,0x90,0xa0,0xf0,0xc8,0x3f,0x9b,0xcf,0x91,0x78,0x32,0x0b,0xb8,
+	0x3a,0x0a,0x98,0x87,0x49,0x43,0x23,0x72,0x2b,0xba,0x5b,0x14,0x1b,0xad,0xb0,0xe9,
+	0x65,0x20,0x61,0xd2,0xc8,0x90,0x3a,0x59,0x17,0x12,0xb2,0x56,0x6b,0x90,0x55,0x5b,
+	0xfd,0x57,0xf5,0xff,0xac,0x7f,0xe0,0x02,0x00,0x20,0x29,0xf3,0x54,0x68,0x12,0xbc,
+	0xe3,0xfe,0xad,0x7f,0x6b,0xbe,0x3c,0x7f,0x91,0xda,0xf1,0x22,0xc7,0x08,0x7a,0x25,
+	0xdd,0x02,0x07,0xd2,0x7d,0x27,0xd2,0x75,0x49,0xc9,0xaa,0x5a,0x76,0xbe,0xd5,0x2d,
+	0xcc,0x3f,0xdd,0x3f,0xb5,0xbf,0x6b,0xe4,0xf4,0x18,0xfd,0x38,0x61,0x7d,0xe1,0x7a,
+	0xe0,0x9b,0xdf,0xfd,0x7d,0xb6,0xbd,0xe3,0xdd,0xb5,0xfb,0x5d,0xb6,0xd4,0x00,0x40,
+	0x04,0x00,0x23,0xc4,0x51,0xf4,0xba,0x0f,0x4c,0x3a,0x83,0x0f,0x87,0xe9,0x69,0x05,
+	0xa0,0x97,0x4a,0x30,0xe1,0x87,0x26,0xa8,0x18,0x7b,0xad,0xa5,0xc2,0x0b,0xa5,0x6f,
+	0xed,0xf0,0xc3,0xed,0xf4,0xf8,0x40,0xb8,0x41,0x7a,0xe1,0x87,0xdb,0xa4,0x18,0x7e,
+	0xf4,0x0b,0xc1,0x02,0xd4,0x14,0x00,0x40,0x04,0x00,0x34,0x88,0xf1,0xa0,0x85,0xe3,
+	0x50,0x9e,0xdc,0x57,0xd9,0x63,0x89,0x06,0xfd,0xec,0x57,0xe4,0x4a,0xff,0x84,0x74,
+	0x17,0xe8,0xce,0x35,0xff,0xff,0x90,0xa8,0xff,0xce,0x21,0x3f,0x49,0x7f,0xfa,0xff,
+	0xff,0xff,0xff,0xff,0xff,0xbf,0xfb,0xb7,0xf7,0xf6,0xdf,0x7f,0xdf,0xdb,0x8f,0xdc,
+	0x7d,0xfb,0x78,0x44,0x51,0x1f,0x61,0x12,0x51,0xee,0x09,0x37,0x6e,0x21,0x78,0x82,
+	0xf2,0x28,0xae,0xc2,0xb8,0xc8,0xa6,0xae,0x00,0x20,0x02,0x00,0x21,0xdf,0xce,0x05,
+	0x82,0xc2,0x91,0x57,0x93,0xf2,0x28,0xd1,0x0a,0xf0,0xa4,0x17,0x08,0x1d,0x22,0x0d,
+	0x5e,0x4d,0xe2,0x8b,0xe1,0x9f,0xe8,0xd4,0x19,0x41,0xa4,0x44,0xc4,0xe4,0xa6,0xa5,
+	0xf7,0xaf,0xab,0xff,0xe9,0x57,0xf7,0xe4,0x20,0xae,0x88,0x67,0x31,0xcd,0x04,0x1b,
+	0x8c,0xf0,0xcc,0x39,0x06,0x9b,0xda,0xcc,0xc1,0xa6,0x39,0x4e,0x1b,0x39,0x50,0x18,
+	0x5c,0x24,0x60,0x64,0xd4,0xb4,0x4e,0x63,0xbc,0x24,0xd4,0x00,0x40,0x04,0x39,0x10,
+	0xd9,0xac,0xc9,0x07,0xbb,0x0c,0x25,0xf6,0x2b,0xe1,0x85,0xd4,0x18,0x2f,0x43,0x6e,
+	0xa4,0xd5,0x63,0x87,0xe1,0xb7,0x6f,0x86,0x2c,0x88,0x8f,0xd7,0xcc,0x7d,0xbd,0x36,
+	0xee,0x66,0x08,0xdc,0x88,0x1b,0x18,0x59,0x02,0x2d,0xf9,0x06,0xe6,0xb2,0x14,0x87,
+	0xcd,0xf6,0x4a,0xa6,0x5c,0x66,0xba,0x13,0x18,0x3a,0x61,0x52,0x0c,0x2e,0x34,0xab,
+	0x4a,0x12,0x84,0xa9,0x61,0x61,0x46,0x00,0x20,0x02,0x22,0xe7,0x0d,0xdb,0xb0,0xe0,
+	0xb0,0x82,0x84,0x0b,0x0a,0x1b,0xb0,0xed,0xc2,0x0e,0x44,0x81,0x32,0x28,0x46,0x15,
+	0xb9,0x35,0x83,0x79,0x10,0x9b,0xc8,0x3d,0x6e,0x0c,0x86,0x03,0x0a,0x68,0x0e,0xcc,
+	0x04,0x74,0x04,0xb9,0x18,0x1d,0xe4,0x20,0x3c,0xa4,0x0b,0x07,0x91,0x33,0x83,0xc7,
+	0xc0,0x04,0x00,0x40,0x2b,0x43,0x3b,0x35,0x0d,0xff,0xff,0xff,0xff,0x00,0x10,0x01,
+	0x26,0xa2,0x9c,0x8a,0x73,0x24,0x44,0x7e,0x71,0xe1,0x21,0x1b,0x0f,0x04,0x15,0x8c,
+	0x20,0xa1,0xcf,0x89,0x0e,0x5c,0x2c,0x31,0x0b,0x21,0x0a,0x99,0x82,0x87,0xff,0xff,
+	0xf8,0x00,0x80,0x08,0xff,0xff,0xff,0xff,0x00,0x10,0x01,0x00,0xff,0xff,0xff,0xff,
+	0x00,0x10,0x01,0x00,0x08,0x00,0x00,0x00,0x10,0x00,0x00,0x00,0x18,0x00,0x00,0x00,
+	0x42,0x00,0x00,0x00,0x5e,0x00,0x00,0x00,0xa4,0x00,0x00,0x00,0xea,0x00,0x00,0x00,
+	0x32,0x01,0x00,0x00,0x6a,0x01,0x00,0x00,0xbc,0x01,0x00,0x00,0x0e,0x02,0x00,0x00,
+	0x5a,0x02,0x00,0x00,0x94,0x02,0x00,0x00,0xa0,0x02,0x00,0x00,0xc4,0x02,0x00,0x00,
+	0xcc,0x02,0x00,0x00,0x07,0x00,0x00,0x00,0x07,0x00,0x00,0x00,0x29,0x00,0x00,0x00,
+	0x1c,0x00,0x00,0x00,0x46,0x00,0x00,0x00,0x46,0x00,0x00,0x00,0x47,0x00,0x00,0x00,
+	0x37,0x00,0x00,0x00,0x51,0x00,0x00,0x00,0x52,0x00,0x00,0x00,0x4c,0x00,0x00,0x00,
+	0x3a,0x00,0x00,0x00,0x0c,0x00,0x00,0x00,0x24,0x00,0x00,0x00,0x07,0x00,0x00,0x00,
+	0x07,0x00,0x00,0x00,0x0a,0x00,0x00,0x01,0x04,0x00,0x01,0x00,0x00,0x00,0xfa,0x00,
+	0x00,0x00,0x01,0x01,0x04,0x00,0x01,0x00,0x00,0x00,0x7a,0x00,0x00,0x00,0x02,0x01,
+	0x03,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x01,0x03,0x00,0x01,0x00,
+	0x00,0x00,0x04,0x00,0x00,0x00,0x06,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x15,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x42,0x01,
+	0x04,0x00,0x01,0x00,0x00,0x00,0x40,0x00,0x00,0x00,0x43,0x01,0x04,0x00,0x01,0x00,
+	0x00,0x00,0x20,0x00,0x00,0x00,0x44,0x01,0x04,0x00,0x10,0x00,0x00,0x00,0xd4,0x02,
+	0x00,0x00,0x45,0x01,0x04,0x00,0x10,0x00,0x00,0x00,0x14,0x03,0x00,0x00,0x00,0x00,
+	0x00,0x00};
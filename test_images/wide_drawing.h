@@ -0,0 +1,81 @@
+//
+// wide_drawing
+// Data size = 1114 bytes
+//
+// TIFF, Compression=G4, Size: 12000 x 96, 1-Bpp
+//
+// for non-Arduino builds...
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t wide_drawing[] PROGMEM = {
+	0x4d,0x4d,0x00,0x2a,0x00,0x00,0x03,0xe8,0x26,0xa0,0x3e,0x03,0xe0,0x3e,0x03,0xe0,
+	0x65,0x06,0xae,0x75,0xcd,0x48,0x36,0x37,0x39,0xda,0x82,0xe7,0x6a,0x0b,0x9d,0xa8,
+	0x2e,0x76,0xa0,0xb9,0xda,0x82,0xe7,0x6a,0x0b,0x9d,0xa8,0x2e,0x76,0xa0,0xb9,0xda,
+	0x82,0xe7,0x6a,0x0b,0x9d,0xa8,0x2e,0x76,0x40,0xbe,0x25,0x68,0x1b,0x3f,0xff,0xff,
+	0xfc,0x4a,0xd0,0x36,0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,0xff,0xff,0xff,0xcb,0x22,
+	0x9e,0x77,0x50,0x36,0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,0xff,0xff,0xff,0xf1,0x2b,
+	0x40,0xd9,0xff,0xff,0xff,0xe2,0x56,0x81,0xb3,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,
+	0xff,0xff,0xff,0x89,0x5a,0x06,0xcf,0xff,0xff,0xff,0x12,0xb4,0x0d,0x9f,0xff,0xff,
+	0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,0x7f,0xff,0xff,0xf8,0x95,
+	0xa0,0x6c,0xff,0xff,0xff,0xf1,0xca,0x98,0x36,0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,
+	0xff,0xff,0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,0xe2,0x56,0x81,0xb3,0xff,0xff,
+	0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0x89,0x5a,0x06,0xcf,0xff,0xff,0xff,0x12,
+	0xb4,0x0d,0x9f,0xff,0xff,0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,
+	0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,0xff,0xff,0xff,0xf1,0xc8,0x80,0x6c,0xff,0xff,
+	0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,0xe2,0x56,0x81,0xb3,0xff,0xff,0xff,0xc4,
+	0xad,0x03,0x67,0xff,0xff,0xff,0x20,0x78,0x14,0x37,0x13,0x20,0xd8,0xdc,0xb4,0x81,
+	0xe0,0x51,0x27,0x96,0x45,0x30,0x3c,0x0a,0x32,0xba,0xc8,0x1e,0x05,0x12,0x07,0x81,
+	0x43,0x41,0x29,0x03,0xc0,0xa2,0x4f,0x2c,0x8a,0x60,0x78,0x14,0x65,0x75,0x90,0x3c,
+	0x0a,0x24,0x0f,0x02,0x86,0x90,0x5f,0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,0xff,
+	0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,
+	0xff,0xf8,0xff,0xff,0xff,0xff,0xff,0xe5,0x58,0x36,0x7f,0xff,0xff,0xff,0xf9,0x66,
+	0x16,0x81,0xe0,0x51,0x3b,0x22,0x99,0x03,0xc0,0xa0,0xd9,0x54,0x83,0x62,0xe4,0xc8,
+	0x1e,0x05,0x0d,0x04,0xa4,0x0f,0x02,0x86,0x82,0x52,0x07,0x81,0x44,0x9c,0xec,0x8a,
+	0x64,0x0f,0x02,0x83,0x64,0xb9,0x5d,0x64,0x0f,0x02,0x81,0x90,0x3c,0x0a,0x1a,0x09,
+	0x48,0x1e,0x05,0x12,0x73,0xb5,0x05,0xff,0xff,0xf9,0x36,0x4b,0xce,0xc2,0x03,0x67,
+	0xff,0xff,0xff,0xff,0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xff,0xff,0xf1,0xff,0xff,
+	0xff,0xff,0xff,0xf2,0x70,0x6c,0xff,0xff,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,
+	0xff,0xff,0xf9,0x64,0x53,0x03,0xc0,0xa0,0x72,0xba,0xc8,0x1e,0x05,0x03,0x20,0x78,
+	0x14,0x32,0x71,0x06,0xc9,0x4c,0x81,0xe0,0x51,0x27,0x3b,0x22,0x99,0x03,0xc0,0xa0,
+	0xd9,0x2e,0x57,0x59,0x03,0xc0,0xa0,0x64,0x0f,0x02,0x86,0x82,0x52,0x07,0x81,0x44,
+	0x9c,0xec,0x8a,0x64,0x0f,0x02,0x83,0x64,0xb9,0x5d,0x64,0x0f,0x02,0x8f,0xff,0xff,
+	0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0xff,0xff,0x8f,0xff,0xff,0xff,0xff,0xff,0xc8,
+	0x64,0x06,0x5e,0xc6,0xbf,0xff,0xff,0xff,0xff,0xf2,0x07,0x81,0x46,0xcc,0x7f,0xff,
+	0xff,0xff,0xff,0xf3,0x27,0xca,0xd0,0x36,0x7f,0xff,0xff,0xff,0x8c,0x81,0xe0,0x50,
+	0xd0,0x4a,0x40,0xf0,0x28,0x93,0x9d,0x91,0x4c,0x81,0xe0,0x50,0x6c,0x97,0x12,0xb4,
+	0x0d,0x84,0x94,0x0f,0x02,0x81,0x90,0x3c,0x0a,0x1a,0x09,0x48,0x1e,0x05,0x12,0x73,
+	0xb2,0x29,0x90,0x3c,0x0a,0x0d,0x92,0xe5,0x75,0x90,0x3c,0x0a,0x06,0x40,0xf0,0x28,
+	0x69,0x05,0xff,0xff,0xff,0x1f,0xff,0xff,0xff,0xff,0xf9,0x0c,0x80,0xed,0x02,0x7f,
+	0xff,0xff,0xff,0xff,0x90,0x3c,0x0a,0x36,0x19,0x06,0xc6,0x51,0xff,0xff,0xff,0xff,
+	0xff,0x89,0x5a,0x06,0xcf,0xff,0xff,0xff,0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,
+	0xe5,0x98,0x5a,0x07,0x81,0x44,0xec,0x8a,0x64,0x0f,0x02,0x83,0x64,0xb9,0x5d,0x64,
+	0x0f,0x02,0x81,0x90,0x3c,0x0a,0x1a,0x0a,0xc8,0x64,0x39,0x39,0xd9,0x14,0xc8,0x1e,
+	0x05,0x06,0xc9,0x72,0xba,0xc8,0x1e,0x05,0x03,0x20,0x78,0x14,0x34,0x12,0x90,0x3c,
+	0x0a,0x24,0xe7,0x6a,0x0b,0xff,0xff,0xff,0xcb,0x41,0x28,0x1e,0x0b,0x5f,0xff,0xff,
+	0xff,0xff,0xf2,0x07,0x81,0x41,0x99,0x06,0xc3,0x1f,0xff,0xff,0xff,0xff,0xf1,0xca,
+	0x40,0x6c,0xff,0xff,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0xff,0xfe,
+	0x25,0x68,0x1b,0x3f,0xff,0xff,0xf1,0xc7,0x19,0xda,0x82,0xf1,0x2b,0x40,0xd8,0x38,
+	0xce,0xd4,0x17,0xff,0xff,0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,
+	0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,0xff,0xff,0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,
+	0xff,0xe2,0x56,0x81,0xb3,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0x8a,
+	0x20,0xd8,0xd4,0x1f,0xff,0xff,0xfe,0xcf,0xb0,0x32,0x0d,0x8d,0x21,0xbf,0xff,0xff,
+	0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,0x7f,0xff,0xff,0xf8,0x95,
+	0xa0,0x6c,0xff,0xff,0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,0xe2,0x56,0x81,0xb3,
+	0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0x89,0x5a,0x06,0xcf,0xff,0xff,
+	0xff,0x12,0xb4,0x0d,0x9f,0xff,0xff,0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xf2,0xd4,
+	0x17,0xce,0xcd,0x41,0xb3,0xff,0xff,0xff,0xc4,0xad,0x03,0x67,0xff,0xff,0xff,0x89,
+	0x5a,0x06,0xcf,0xff,0xff,0xff,0x12,0xb4,0x0d,0x9f,0xff,0xff,0xfe,0x25,0x68,0x1b,
+	0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,0x7f,0xff,0xff,0xf8,0x95,0xa0,0x6c,0xff,0xff,
+	0xff,0xf1,0x2b,0x40,0xd9,0xff,0xff,0xff,0xe2,0x56,0x81,0xb3,0xff,0xff,0xff,0xc4,
+	0xad,0x03,0x67,0xff,0xff,0xff,0x8e,0x44,0xc1,0xb3,0xff,0xff,0xff,0xc4,0xad,0x03,
+	0x67,0xff,0xff,0xff,0x89,0x5a,0x06,0xcf,0xff,0xff,0xff,0x12,0xb4,0x0d,0x9f,0xff,
+	0xff,0xfe,0x25,0x68,0x1b,0x3f,0xff,0xff,0xfc,0x4a,0xd0,0x36,0x7f,0xc4,0x44,0x44,
+	0x44,0x44,0x44,0x44,0x78,0x00,0x80,0x08,0x00,0x09,0x01,0x00,0x00,0x04,0x00,0x00,
+	0x00,0x01,0x00,0x00,0x2e,0xe0,0x01,0x01,0x00,0x04,0x00,0x00,0x00,0x01,0x00,0x00,
+	0x00,0x60,0x01,0x02,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x00,0x01,0x03,
+	0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x04,0x00,0x00,0x01,0x06,0x00,0x03,0x00,0x00,
+	0x00,0x01,0x00,0x00,0x00,0x00,0x01,0x11,0x00,0x04,0x00,0x00,0x00,0x01,0x00,0x00,
+	0x00,0x08,0x01,0x15,0x00,0x03,0x00,0x00,0x00,0x01,0x00,0x01,0x00,0x00,0x01,0x16,
+	0x00,0x04,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x60,0x01,0x17,0x00,0x04,0x00,0x00,
+	0x00,0x01,0x00,0x00,0x03,0xe0,0x00,0x00,0x00,0x00};